@@ -0,0 +1,70 @@
+# 将PEM格式的公钥转换为DER字节数组头文件，供编译进程序使用
+# 用法: cmake -DPEM_FILE=<public.pem> -DOUTPUT_FILE=<EmbeddedPublicKey.h> -P EmbedPublicKey.cmake
+
+if(NOT DEFINED PEM_FILE OR NOT DEFINED OUTPUT_FILE)
+    message(FATAL_ERROR "EmbedPublicKey.cmake 需要 PEM_FILE 和 OUTPUT_FILE 参数")
+endif()
+
+file(READ "${PEM_FILE}" pem)
+if(NOT pem MATCHES "-----BEGIN PUBLIC KEY-----(.*)-----END PUBLIC KEY-----")
+    message(FATAL_ERROR "${PEM_FILE} 不是 PEM 格式的公钥 (BEGIN PUBLIC KEY)")
+endif()
+string(REGEX REPLACE "[^A-Za-z0-9+/]" "" body "${CMAKE_MATCH_1}")
+
+# Base64解码，逐字符累积6位，满8位输出一个字节
+set(alphabet "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/")
+set(hex_digits 0 1 2 3 4 5 6 7 8 9 a b c d e f)
+string(LENGTH "${body}" body_len)
+set(val 0)
+set(bits 0)
+set(count 0)
+set(bytes "")
+if(body_len GREATER 0)
+    math(EXPR last "${body_len} - 1")
+    foreach(i RANGE ${last})
+        string(SUBSTRING "${body}" ${i} 1 ch)
+        string(FIND "${alphabet}" "${ch}" idx)
+        math(EXPR val "((${val} << 6) | ${idx}) & 0xFFFF")
+        math(EXPR bits "${bits} + 6")
+        if(bits GREATER_EQUAL 8)
+            math(EXPR bits "${bits} - 8")
+            math(EXPR byte "(${val} >> ${bits}) & 0xFF")
+            math(EXPR hi "${byte} >> 4")
+            math(EXPR lo "${byte} & 0xF")
+            list(GET hex_digits ${hi} hi)
+            list(GET hex_digits ${lo} lo)
+            math(EXPR column "${count} % 12")
+            if(column EQUAL 0)
+                string(APPEND bytes "\n   ")
+            endif()
+            string(APPEND bytes " 0x${hi}${lo},")
+            math(EXPR count "${count} + 1")
+        endif()
+    endforeach()
+endif()
+if(count EQUAL 0)
+    message(FATAL_ERROR "${PEM_FILE} 中的公钥内容为空")
+endif()
+
+set(content "// 由 cmake/EmbedPublicKey.cmake 根据 ${PEM_FILE} 生成，请勿手动修改
+#ifndef EMBEDDEDPUBLICKEY_H
+#define EMBEDDEDPUBLICKEY_H
+
+#include <cstddef>
+
+/// 编译进程序的公钥(DER格式，SubjectPublicKeyInfo)
+inline constexpr unsigned char embedded_public_key_der[] = {${bytes}
+};
+inline constexpr size_t embedded_public_key_der_size = sizeof(embedded_public_key_der);
+
+#endif // EMBEDDEDPUBLICKEY_H
+")
+
+# 内容未变化时不改写文件，避免触发重新编译
+if(EXISTS "${OUTPUT_FILE}")
+    file(READ "${OUTPUT_FILE}" old_content)
+    if(old_content STREQUAL content)
+        return()
+    endif()
+endif()
+file(WRITE "${OUTPUT_FILE}" "${content}")
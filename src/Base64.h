@@ -1,16 +1,17 @@
 #ifndef BASE64_H
 #define BASE64_H
 
+#include <cstdint>
 #include <string>
-#include <vector>
+#include <string_view>
 
-const static char* base64_chars =
+inline constexpr char base64_chars[] =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
     "abcdefghijklmnopqrstuvwxyz"
     "0123456789+/";
 
 // Base64编码
-std::string base64_encode(const std::string &bytes) {
+inline std::string base64_encode(const std::string &bytes) {
     std::string encoded;
     size_t i = 0;
     uint8_t a, b, c;
@@ -49,28 +50,54 @@ std::string base64_encode(const std::string &bytes) {
     return encoded;
 }
 
-// Base64解码
-std::string base64_decode(const std::string &encoded) {
-    std::string decoded;
-    std::vector<int> T(256, -1);
+// Base64解码查找表，非Base64字符为-1
+inline const int *base64_decode_table() {
+    static const struct Table {
+        int T[256];
+        Table() {
+            for (int i = 0; i < 256; i++) {
+                T[i] = -1;
+            }
+            for (int i = 0; i < 64; i++) {
+                T[static_cast<uint8_t>(base64_chars[i])] = i;
+            }
+        }
+    } table;
+    return table.T;
+}
 
-    // 初始化查找表
-    for (int i = 0; i < 64; i++) {
-        T[base64_chars[i]] = i;
-    }
+// 解码后的最大长度，用于预先分配输出缓冲区
+inline size_t base64_decoded_size(size_t encodedLen) {
+    return encodedLen / 4 * 3 + 3;
+}
+
+// Base64解码到调用方提供的缓冲区，不分配内存
+// out 至少需要 base64_decoded_size(len) 字节，返回解码后的字节数
+inline size_t base64_decode(const char *encoded, size_t len, char *out) {
+    const int *T = base64_decode_table();
+    size_t n = 0;
 
     // 处理每4个字符
-    int val = 0, val_bits = -8;
-    for (uint8_t c : encoded) {
+    uint32_t val = 0;
+    int val_bits = -8;
+    for (size_t i = 0; i < len; i++) {
+        uint8_t c = static_cast<uint8_t>(encoded[i]);
         if (T[c] == -1) break;  // 跳过非Base64字符或填充
         val = (val << 6) + T[c];
         val_bits += 6;
         if (val_bits >= 0) {
-            decoded.push_back(char((val >> val_bits) & 0xFF));
+            out[n++] = char((val >> val_bits) & 0xFF);
             val_bits -= 8;
         }
     }
 
+    return n;
+}
+
+// Base64解码
+inline std::string base64_decode(std::string_view encoded) {
+    std::string decoded(base64_decoded_size(encoded.size()), '\0');
+    decoded.resize(base64_decode(encoded.data(), encoded.size(), &decoded[0]));
     return decoded;
 }
 #endif // BASE64_H
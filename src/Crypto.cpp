@@ -1,16 +1,28 @@
 #include "Crypto.h"
+#include "Ed25519.h"
 #include <iostream>
 #include <filesystem>
+#include <mutex>
 namespace fs = std::filesystem;
 
-Crypto::Crypto() : _privateKey(nullptr), _publicKey(nullptr) {
-    // 仅在OpenSSL 3.0+需要显式初始化
+Crypto::Crypto()
+    : _privateKey(nullptr), _publicKey(nullptr), _ed25519PublicKey{},
+      _hasEd25519PublicKey(false) {
+    initLibrary();
+}
+
+void Crypto::initLibrary() {
+    // 每个进程只初始化一次
+    static std::once_flag flag;
+    std::call_once(flag, [] {
+        // 仅在OpenSSL 3.0+需要显式初始化
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
-    // 初始化OpenSSL库
-    OpenSSL_add_all_algorithms();
-    // 初始化错误处理
-    ERR_load_crypto_strings();
+        // 初始化OpenSSL库
+        OpenSSL_add_all_algorithms();
+        // 初始化错误处理
+        ERR_load_crypto_strings();
 #endif
+    });
 }
 
 Crypto::~Crypto() {
@@ -80,13 +92,13 @@ bool Crypto::loadPublicKeyFile(const std::string &path) {
     #ifdef _WIN32
     // 从文件读取 PEM 内容到字符串
     FILE* file = nullptr;
-    errno_t err = _wfopen_s(&file, filePath.c_str(), L"r");
+    errno_t err = _wfopen_s(&file, filePath.c_str(), L"rb");
     if (err != 0) {
         std::cerr << "open PublicKey file error" << std::endl;
         return false;
     }
     #else
-    FILE* file = fopen(filePath.c_str(), "r");
+    FILE* file = fopen(filePath.c_str(), "rb");
     if(file == nullptr)
     {
         std::cerr << "open PublicKey file error" << std::endl;
@@ -103,6 +115,12 @@ bool Crypto::loadPublicKeyFile(const std::string &path) {
     fread(pem_data, 1, size, file);
     pem_data[size] = '\0';  // 确保字符串以 \0 结尾
     fclose(file);
+    // 非PEM内容按DER格式解析，跳过Base64解码
+    if (size > 0 && static_cast<unsigned char>(pem_data[0]) == 0x30) {
+        bool ok = loadPublicKeyDer(reinterpret_cast<const unsigned char*>(pem_data), static_cast<size_t>(size));
+        free(pem_data);
+        return ok;
+    }
     std::string pem_str(pem_data);
     free(pem_data);
     return loadPublicKeyStr(pem_str);
@@ -111,6 +129,8 @@ bool Crypto::loadPublicKeyStr(const std::string &key) {
     if (_publicKey) {
         EVP_PKEY_free(_publicKey);
         _publicKey = nullptr;
+        _publicKeyDer.clear();
+        _hasEd25519PublicKey = false;
     }
     BIO *bio = BIO_new_mem_buf(key.c_str(), -1);
     if (!bio) {
@@ -123,8 +143,37 @@ bool Crypto::loadPublicKeyStr(const std::string &key) {
         std::cerr << "读取公钥失败: " << ERR_error_string(ERR_get_error(), nullptr) << std::endl;
         return false;
     }
+    updatePublicKeyDer();
+    updateEd25519PublicKey();
+    return true;
+}
+bool Crypto::loadPublicKeyDer(const unsigned char *der, size_t len) {
+    if (_publicKey) {
+        EVP_PKEY_free(_publicKey);
+        _publicKey = nullptr;
+        _publicKeyDer.clear();
+        _hasEd25519PublicKey = false;
+    }
+    const unsigned char *p = der;
+    _publicKey = d2i_PUBKEY(nullptr, &p, static_cast<long>(len));
+    if (!_publicKey) {
+        std::cerr << "读取公钥失败: " << ERR_error_string(ERR_get_error(), nullptr) << std::endl;
+        return false;
+    }
+    // 直接保存调用方的DER字节(d2i实际解析的部分)，无需重新编码
+    _publicKeyDer.assign(reinterpret_cast<const char*>(der), static_cast<size_t>(p - der));
+    updateEd25519PublicKey();
     return true;
 }
+void Crypto::updatePublicKeyDer() {
+    _publicKeyDer.clear();
+    int len = i2d_PUBKEY(_publicKey, nullptr);
+    if (len <= 0)
+        return;
+    _publicKeyDer.resize(len);
+    unsigned char *p = reinterpret_cast<unsigned char*>(&_publicKeyDer[0]);
+    i2d_PUBKEY(_publicKey, &p);
+}
 std::string Crypto::signData(const std::string &data) {
     if (!_privateKey) {
         std::cerr << "未加载私钥，无法签名" << std::endl;
@@ -135,12 +184,31 @@ std::string Crypto::signData(const std::string &data) {
         std::cerr << "创建EVP_MD_CTX失败" << std::endl;
         return {};
     }
-    // 示例使用SHA256算法，实际可调整
-    if (EVP_DigestSignInit(ctx, nullptr, EVP_sha256(), nullptr, _privateKey) != 1) {
+    // Ed25519自带哈希且只支持一次性签名，其他密钥使用SHA256
+    bool ed25519 = EVP_PKEY_id(_privateKey) == EVP_PKEY_ED25519;
+    if (EVP_DigestSignInit(ctx, nullptr, ed25519 ? nullptr : EVP_sha256(), nullptr, _privateKey) != 1) {
         std::cerr << "初始化签名失败: " << ERR_error_string(ERR_get_error(), nullptr) << std::endl;
         EVP_MD_CTX_free(ctx);
         return {};
     }
+    if (ed25519) {
+        size_t sig_len = 0;
+        if (EVP_DigestSign(ctx, nullptr, &sig_len, reinterpret_cast<const unsigned char*>(data.data()), data.size()) != 1) {
+            std::cerr << "获取签名长度失败: " << ERR_error_string(ERR_get_error(), nullptr) << std::endl;
+            EVP_MD_CTX_free(ctx);
+            return {};
+        }
+        std::string signature(sig_len, 0);
+        if (EVP_DigestSign(ctx, reinterpret_cast<unsigned char*>(signature.data()), &sig_len,
+                           reinterpret_cast<const unsigned char*>(data.data()), data.size()) != 1) {
+            std::cerr << "生成签名失败: " << ERR_error_string(ERR_get_error(), nullptr) << std::endl;
+            EVP_MD_CTX_free(ctx);
+            return {};
+        }
+        EVP_MD_CTX_free(ctx);
+        signature.resize(sig_len);
+        return signature;
+    }
     if (EVP_DigestSignUpdate(ctx, data.c_str(), data.size()) != 1) {
         std::cerr << "更新签名数据失败: " << ERR_error_string(ERR_get_error(), nullptr) << std::endl;
         EVP_MD_CTX_free(ctx);
@@ -162,7 +230,35 @@ std::string Crypto::signData(const std::string &data) {
     return signature;
 }
 
+bool Crypto::verifySignatureNoAlloc(const unsigned char *data, size_t dataLen,
+                                    const unsigned char *signature, size_t signatureLen) {
+    // OpenSSL每次验证都会重建EVP_PKEY_CTX并分配内存，Ed25519公钥改用自包含实现
+    if (!_hasEd25519PublicKey)
+        return verifySignature(data, dataLen, signature, signatureLen);
+    if (signatureLen != Ed25519::SIGNATURE_SIZE ||
+        !Ed25519::verify(signature, data, dataLen, _ed25519PublicKey)) {
+        std::cerr << "验证签名失败: 签名不匹配" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 保存Ed25519公钥的原始字节，其他类型的公钥仍由OpenSSL验证
+void Crypto::updateEd25519PublicKey() {
+    size_t len = sizeof(_ed25519PublicKey);
+    _hasEd25519PublicKey =
+        EVP_PKEY_id(_publicKey) == EVP_PKEY_ED25519 &&
+        EVP_PKEY_get_raw_public_key(_publicKey, _ed25519PublicKey, &len) == 1 &&
+        len == sizeof(_ed25519PublicKey);
+}
+
 bool Crypto::verifySignature(const std::string &data, const std::string &signature) {
+    return verifySignature(reinterpret_cast<const unsigned char*>(data.data()), data.size(),
+                           reinterpret_cast<const unsigned char*>(signature.data()), signature.size());
+}
+
+bool Crypto::verifySignature(const unsigned char *data, size_t dataLen,
+                             const unsigned char *signature, size_t signatureLen) {
     if (!_publicKey) {
         std::cerr << "未加载公钥，无法验证" << std::endl;
         return false;
@@ -172,17 +268,24 @@ bool Crypto::verifySignature(const std::string &data, const std::string &signatu
         std::cerr << "创建EVP_MD_CTX失败" << std::endl;
         return false;
     }
-    if (EVP_DigestVerifyInit(ctx, nullptr, EVP_sha256(), nullptr, _publicKey) != 1) {
+    // Ed25519自带哈希且只支持一次性验证，其他密钥使用SHA256
+    bool ed25519 = EVP_PKEY_id(_publicKey) == EVP_PKEY_ED25519;
+    if (EVP_DigestVerifyInit(ctx, nullptr, ed25519 ? nullptr : EVP_sha256(), nullptr, _publicKey) != 1) {
         std::cerr << "初始化验证失败: " << ERR_error_string(ERR_get_error(), nullptr) << std::endl;
         EVP_MD_CTX_free(ctx);
         return false;
     }
-    if (EVP_DigestVerifyUpdate(ctx, data.c_str(), data.size()) != 1) {
-        std::cerr << "更新验证数据失败: " << ERR_error_string(ERR_get_error(), nullptr) << std::endl;
-        EVP_MD_CTX_free(ctx);
-        return false;
+    int ret;
+    if (ed25519) {
+        ret = EVP_DigestVerify(ctx, signature, signatureLen, data, dataLen);
+    } else {
+        if (EVP_DigestVerifyUpdate(ctx, data, dataLen) != 1) {
+            std::cerr << "更新验证数据失败: " << ERR_error_string(ERR_get_error(), nullptr) << std::endl;
+            EVP_MD_CTX_free(ctx);
+            return false;
+        }
+        ret = EVP_DigestVerifyFinal(ctx, signature, signatureLen);
     }
-    int ret = EVP_DigestVerifyFinal(ctx, reinterpret_cast<const unsigned char*>(signature.c_str()), signature.size());
     EVP_MD_CTX_free(ctx);
     if (ret != 1) {
         std::cerr << "验证签名失败: " << (ret == 0 ? "签名不匹配" : ERR_error_string(ERR_get_error(), nullptr)) << std::endl;
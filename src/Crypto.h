@@ -1,6 +1,7 @@
 #ifndef CRYPTO_H
 #define CRYPTO_H
 
+#include <cstddef>
 #include <string>
 #include <openssl/rsa.h>
 #include <openssl/pem.h>
@@ -14,11 +15,24 @@ public:
     bool loadPublicKeyFile(const std::string &path);
     bool loadPrivateKeyStr(const std::string &key);
     bool loadPublicKeyStr(const std::string &key);
+    bool loadPublicKeyDer(const unsigned char *der, size_t len);
     std::string signData(const std::string &data);
     bool verifySignature(const std::string &data, const std::string &signature);
+    bool verifySignature(const unsigned char *data, size_t dataLen,
+                         const unsigned char *signature, size_t signatureLen);
+    // 不分配内存的验证：Ed25519公钥使用自包含实现，其他公钥与verifySignature相同
+    bool verifySignatureNoAlloc(const unsigned char *data, size_t dataLen,
+                                const unsigned char *signature, size_t signatureLen);
+    const std::string &publicKeyDer() const { return _publicKeyDer; }
 private:
+    static void initLibrary();
+    void updatePublicKeyDer(); ///< PEM加载路径使用，DER加载直接保存输入字节
+    void updateEd25519PublicKey();
     EVP_PKEY *_privateKey;
     EVP_PKEY *_publicKey;
+    std::string _publicKeyDer; ///< 已加载公钥的DER编码，用作公钥标识
+    unsigned char _ed25519PublicKey[32]; ///< Ed25519公钥原始字节，验证时不经过OpenSSL
+    bool _hasEd25519PublicKey;
 };
 
 #endif // CRYPTO_H
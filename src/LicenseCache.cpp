@@ -0,0 +1,374 @@
+#include "LicenseCache.h"
+#include "Sha512.h"
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <filesystem>
+#ifdef _WIN32
+#include <windows.h>
+#include <aclapi.h>
+#include <sddl.h>
+#include <vector>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+namespace fs = std::filesystem;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "共享内存缓存需要无锁的64位原子操作");
+
+namespace {
+
+// 文件格式标识，格式变化时需修改版本号
+const uint64_t CACHE_MAGIC = 0x4C4D43414348ULL << 16 | 1; // "LMCACH" + 版本1
+// 写入槽位时在相邻槽位中查找的范围
+const size_t PROBE_COUNT = 4;
+
+uint64_t mix(uint64_t h, uint64_t v) {
+  h ^= v + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+  h ^= h >> 31;
+  h *= 0xBF58476D1CE4E5B9ULL;
+  h ^= h >> 27;
+  return h;
+}
+
+// 槽位校验和：最低位存放验证结论，次低位恒为1以区分全零的空槽位
+uint64_t checksum(const uint64_t key[4], int64_t validStart, int64_t validEnd,
+                  bool verdict) {
+  uint64_t h = 0;
+  for (int i = 0; i < 4; ++i)
+    h = mix(h, key[i]);
+  h = mix(h, static_cast<uint64_t>(validStart));
+  h = mix(h, static_cast<uint64_t>(validEnd));
+  return (h & ~3ULL) | 2 | (verdict ? 1 : 0);
+}
+
+#ifdef _WIN32
+// 是否为可信的写入方：当前用户、文件所有者权限、SYSTEM或管理员
+bool isTrustedSid(PSID sid, PSID user) {
+  return EqualSid(sid, user) || IsWellKnownSid(sid, WinCreatorOwnerRightsSid) ||
+         IsWellKnownSid(sid, WinLocalSystemSid) ||
+         IsWellKnownSid(sid, WinBuiltinAdministratorsSid);
+}
+
+// 缓存文件必须属于当前用户(或SYSTEM、管理员)，且不允许其他用户写入
+bool isPrivateFile(HANDLE file) {
+  HANDLE token = nullptr;
+  if (!OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &token))
+    return false;
+  DWORD size = 0;
+  GetTokenInformation(token, TokenUser, nullptr, 0, &size);
+  std::vector<unsigned char> buffer(size);
+  bool ok = size > 0 && GetTokenInformation(token, TokenUser, buffer.data(),
+                                            size, &size);
+  CloseHandle(token);
+  if (!ok)
+    return false;
+  PSID user = reinterpret_cast<TOKEN_USER *>(buffer.data())->User.Sid;
+
+  PSID owner = nullptr;
+  PACL dacl = nullptr;
+  PSECURITY_DESCRIPTOR sd = nullptr;
+  if (GetSecurityInfo(file, SE_FILE_OBJECT,
+                      OWNER_SECURITY_INFORMATION | DACL_SECURITY_INFORMATION,
+                      &owner, nullptr, &dacl, nullptr, &sd) != ERROR_SUCCESS)
+    return false;
+  // 以管理员身份运行时新建文件的所有者为Administrators组；空DACL表示任何人都有完全访问权限
+  ok = owner && isTrustedSid(owner, user) && dacl;
+  const DWORD writeMask = FILE_WRITE_DATA | FILE_APPEND_DATA | GENERIC_WRITE |
+                          GENERIC_ALL | WRITE_DAC | WRITE_OWNER;
+  for (DWORD i = 0; ok && i < dacl->AceCount; ++i) {
+    ACE_HEADER *ace = nullptr;
+    if (!GetAce(dacl, i, reinterpret_cast<void **>(&ace)))
+      ok = false;
+    else if (ace->AceType == ACCESS_ALLOWED_ACE_TYPE) {
+      auto *allowed = reinterpret_cast<ACCESS_ALLOWED_ACE *>(ace);
+      if ((allowed->Mask & writeMask) &&
+          !isTrustedSid(reinterpret_cast<PSID>(&allowed->SidStart), user))
+        ok = false;
+    }
+  }
+  LocalFree(sd);
+  return ok;
+}
+#endif
+
+} // namespace
+
+struct LicenseCache::Header {
+  std::atomic<uint64_t> magic;
+  std::atomic<uint64_t> slotCount; ///< 由首个映射文件的进程写入，之后不再改变
+  uint64_t reserved[6];
+};
+
+// 每个槽位占一个缓存行
+struct LicenseCache::Slot {
+  std::atomic<uint64_t> seq; ///< 序列号，奇数表示正在写入
+  std::atomic<uint64_t> key[4];
+  std::atomic<int64_t> validStart;
+  std::atomic<int64_t> validEnd;
+  std::atomic<uint64_t> check; ///< 校验和与验证结论
+};
+
+LicenseCache::LicenseCache()
+    : _header(nullptr), _slots(nullptr), _slotCount(0), _mappedSize(0),
+#ifdef _WIN32
+      _file(nullptr), _mapping(nullptr)
+#else
+      _fd(-1)
+#endif
+{
+}
+
+LicenseCache::~LicenseCache() { close(); }
+
+bool LicenseCache::open(const std::string &path, size_t slotCount) {
+  close();
+  if (slotCount == 0)
+    slotCount = 1;
+  // path 是 UTF-8 字符串
+  fs::path filePath = fs::u8path(path);
+  const uint64_t minSize = sizeof(Header) + sizeof(Slot);
+  uint64_t wantedSize = sizeof(Header) + slotCount * sizeof(Slot);
+  uint64_t fileSize = 0;
+  void *view = nullptr;
+#ifdef _WIN32
+  // 新建文件只允许所有者访问(受保护的DACL，不继承父目录权限)
+  SECURITY_ATTRIBUTES attributes{sizeof(attributes), nullptr, FALSE};
+  if (!ConvertStringSecurityDescriptorToSecurityDescriptorW(
+          L"D:P(A;;GA;;;OW)", SDDL_REVISION_1,
+          &attributes.lpSecurityDescriptor, nullptr)) {
+    std::cerr << "无法创建缓存文件的安全描述符" << std::endl;
+    return false;
+  }
+  HANDLE file = CreateFileW(filePath.c_str(), GENERIC_READ | GENERIC_WRITE,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE, &attributes,
+                            OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  LocalFree(attributes.lpSecurityDescriptor);
+  if (file == INVALID_HANDLE_VALUE) {
+    std::cerr << "无法打开缓存文件: " << path << std::endl;
+    return false;
+  }
+  if (!isPrivateFile(file)) {
+    std::cerr << "缓存文件不属于当前用户或可被其他用户写入: " << path << std::endl;
+    CloseHandle(file);
+    return false;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size)) {
+    CloseHandle(file);
+    return false;
+  }
+  // 新文件由文件映射扩展到所需大小(内容为零)；文件映射只会扩展文件，不会截短
+  fileSize = static_cast<uint64_t>(size.QuadPart) < minSize
+                 ? wantedSize
+                 : static_cast<uint64_t>(size.QuadPart);
+  HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE,
+                                      static_cast<DWORD>(fileSize >> 32),
+                                      static_cast<DWORD>(fileSize), nullptr);
+  if (!mapping) {
+    std::cerr << "创建缓存文件映射失败" << std::endl;
+    CloseHandle(file);
+    return false;
+  }
+  view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0,
+                       static_cast<SIZE_T>(fileSize));
+  if (!view) {
+    std::cerr << "映射缓存文件失败" << std::endl;
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+  _file = file;
+  _mapping = mapping;
+#else
+  // 只允许所有者读写，且不跟随符号链接
+  int fd = ::open(filePath.c_str(), O_RDWR | O_CREAT | O_NOFOLLOW | O_CLOEXEC,
+                  0600);
+  if (fd < 0) {
+    std::cerr << "无法打开缓存文件: " << path << std::endl;
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    ::close(fd);
+    return false;
+  }
+  // 能写入缓存的进程即可让验证通过，拒绝其他用户创建或可写的文件
+  if (!S_ISREG(st.st_mode) || st.st_uid != geteuid() ||
+      (st.st_mode & (S_IWGRP | S_IWOTH))) {
+    std::cerr << "缓存文件不属于当前用户或可被其他用户写入: " << path << std::endl;
+    ::close(fd);
+    return false;
+  }
+  // 新文件扩展到所需大小(内容为零)。posix_fallocate只会扩展文件，
+  // 多个进程以不同槽位数同时创建时文件不会被截短，已建立的映射始终有效
+  if (static_cast<uint64_t>(st.st_size) < minSize) {
+    if (posix_fallocate(fd, 0, static_cast<off_t>(wantedSize)) != 0 ||
+        fstat(fd, &st) != 0) {
+      std::cerr << "无法设置缓存文件大小: " << path << std::endl;
+      ::close(fd);
+      return false;
+    }
+  }
+  fileSize = static_cast<uint64_t>(st.st_size);
+  if (fileSize >= minSize) {
+    view = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+      std::cerr << "映射缓存文件失败" << std::endl;
+      ::close(fd);
+      return false;
+    }
+  }
+  _fd = fd;
+#endif
+  _mappedSize = static_cast<size_t>(fileSize);
+  _header = static_cast<Header *>(view);
+  if (!_header || _mappedSize < minSize) {
+    std::cerr << "缓存文件大小无效: " << path << std::endl;
+    close();
+    return false;
+  }
+  // 零填充的新文件由首个进程写入槽位数和标识，之后各进程都使用头部记录的槽位数，
+  // 与各自映射时文件的大小无关
+  uint64_t count = 0;
+  _header->slotCount.compare_exchange_strong(
+      count, (_mappedSize - sizeof(Header)) / sizeof(Slot));
+  uint64_t magic = 0;
+  _header->magic.compare_exchange_strong(magic, CACHE_MAGIC);
+  if (_header->magic.load() != CACHE_MAGIC) {
+    std::cerr << "缓存文件格式不兼容: " << path << std::endl;
+    close();
+    return false;
+  }
+  count = _header->slotCount.load();
+  if (count == 0 || count > (_mappedSize - sizeof(Header)) / sizeof(Slot)) {
+    std::cerr << "缓存文件大小与槽位数不一致: " << path << std::endl;
+    close();
+    return false;
+  }
+  _slotCount = static_cast<size_t>(count);
+  _slots = reinterpret_cast<Slot *>(reinterpret_cast<char *>(view) + sizeof(Header));
+  return true;
+}
+
+void LicenseCache::close() {
+#ifdef _WIN32
+  if (_header)
+    UnmapViewOfFile(_header);
+  if (_mapping)
+    CloseHandle(_mapping);
+  if (_file)
+    CloseHandle(_file);
+  _mapping = nullptr;
+  _file = nullptr;
+#else
+  if (_header)
+    munmap(_header, _mappedSize);
+  if (_fd >= 0)
+    ::close(_fd);
+  _fd = -1;
+#endif
+  _header = nullptr;
+  _slots = nullptr;
+  _slotCount = 0;
+  _mappedSize = 0;
+}
+
+LicenseCache::Key LicenseCache::makeKey(std::string_view licenseCode,
+                                        std::string_view publicKey,
+                                        std::string_view deviceFingerprint) {
+  // 各字段带长度前缀，避免拼接产生歧义；使用自包含的SHA-512，不分配内存
+  Sha512 sha;
+  for (std::string_view field : {licenseCode, publicKey, deviceFingerprint}) {
+    uint64_t len = field.size();
+    sha.update(&len, sizeof(len));
+    sha.update(field.data(), field.size());
+  }
+  unsigned char digest[Sha512::DIGEST_SIZE];
+  sha.final(digest);
+  Key key;
+  memcpy(key.bytes, digest, sizeof(key.bytes));
+  return key;
+}
+
+bool LicenseCache::lookup(const Key &key, bool &verdict, long long &validStart,
+                          long long &validEnd) const {
+  if (!_slots)
+    return false;
+  uint64_t k[4];
+  memcpy(k, key.bytes, sizeof(k));
+  size_t index = static_cast<size_t>(k[0] % _slotCount);
+  for (size_t probe = 0; probe < PROBE_COUNT && probe < _slotCount; ++probe) {
+    const Slot &slot = _slots[(index + probe) % _slotCount];
+    uint64_t seq = slot.seq.load(std::memory_order_acquire);
+    if (seq & 1)
+      continue;
+    uint64_t sk[4];
+    for (int i = 0; i < 4; ++i)
+      sk[i] = slot.key[i].load(std::memory_order_relaxed);
+    int64_t start = slot.validStart.load(std::memory_order_relaxed);
+    int64_t end = slot.validEnd.load(std::memory_order_relaxed);
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != seq)
+      continue;
+    if (memcmp(sk, k, sizeof(k)) != 0)
+      continue;
+    bool ok = (check & 1) != 0;
+    if (check != checksum(sk, start, end, ok))
+      continue;
+    verdict = ok;
+    validStart = start;
+    validEnd = end;
+    return true;
+  }
+  return false;
+}
+
+void LicenseCache::store(const Key &key, bool verdict, long long validStart,
+                         long long validEnd) {
+  if (!_slots)
+    return;
+  uint64_t k[4];
+  memcpy(k, key.bytes, sizeof(k));
+  size_t index = static_cast<size_t>(k[0] % _slotCount);
+  // 优先复用同键槽位，其次空槽位，否则覆盖首选槽位
+  Slot *target = nullptr;
+  Slot *empty = nullptr;
+  for (size_t probe = 0; probe < PROBE_COUNT && probe < _slotCount; ++probe) {
+    Slot &slot = _slots[(index + probe) % _slotCount];
+    bool same = true;
+    for (int i = 0; i < 4 && same; ++i)
+      same = slot.key[i].load(std::memory_order_relaxed) == k[i];
+    if (same) {
+      target = &slot;
+      break;
+    }
+    if (!empty && slot.check.load(std::memory_order_relaxed) == 0)
+      empty = &slot;
+  }
+  if (!target)
+    target = empty ? empty : &_slots[index];
+
+  // 获取槽位：偶数序号加1；奇数序号可能是崩溃进程遗留的，加2接管
+  uint64_t seq = target->seq.load(std::memory_order_relaxed);
+  uint64_t writing = (seq & 1) ? seq + 2 : seq + 1;
+  if (!target->seq.compare_exchange_strong(seq, writing,
+                                           std::memory_order_acq_rel))
+    return;
+  // 保证读取方看到新数据之前先看到奇数序号
+  std::atomic_thread_fence(std::memory_order_release);
+  for (int i = 0; i < 4; ++i)
+    target->key[i].store(k[i], std::memory_order_relaxed);
+  target->validStart.store(validStart, std::memory_order_relaxed);
+  target->validEnd.store(validEnd, std::memory_order_relaxed);
+  target->check.store(checksum(k, validStart, validEnd, verdict),
+                      std::memory_order_relaxed);
+  // 若期间被其他写入方接管则由对方负责发布
+  target->seq.compare_exchange_strong(writing, writing + 1,
+                                      std::memory_order_release);
+}
@@ -0,0 +1,103 @@
+#ifndef LICENSECACHE_H
+#define LICENSECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief 主机内跨进程共享的许可证验证结果缓存
+ *
+ * 缓存存放在内存映射文件中，同一主机上的多个进程打开同一路径即可共享。
+ * 以许可证代码、公钥和设备指纹的SHA-512摘要(取前32字节)为键，记录验证结论与有效期；
+ * 首个进程完成验证后，其余进程只需几次原子读取即可得到结果。
+ *
+ * 每个槽位使用序列锁(seqlock)保护：读取方发现序号为奇数或前后不一致即视为未命中；
+ * 写入方通过CAS获取槽位，可接管崩溃进程遗留的写入状态，槽位校验和用于识别被撕裂的数据。
+ * 缓存是尽力而为的，数据损坏只会导致未命中。
+ *
+ * 信任边界：命中的通过结论不再验证签名，能写入缓存文件的进程即可让任意许可证通过验证。
+ * 因此缓存文件只允许当前用户访问：新建文件的权限为仅所有者可读写(Windows下为仅所有者访问的DACL)，
+ * 打开已有文件时拒绝不属于当前有效用户或可被其他用户写入的文件，POSIX下不跟随符号链接。
+ * 缓存只能在同一用户的进程之间共享，路径应位于该用户私有的目录中。
+ */
+class LicenseCache {
+public:
+  /// 缓存键：SHA-512摘要的前32字节
+  struct Key {
+    unsigned char bytes[32];
+  };
+
+  LicenseCache();
+  ~LicenseCache();
+
+  /**
+   * @brief 打开(必要时创建)缓存文件并映射到内存
+   * @param path 缓存文件路径，应位于当前用户私有的目录，如 $XDG_RUNTIME_DIR/license.cache
+   * @param slotCount 新建缓存时的槽位数量，文件已存在时使用其头部记录的槽位数
+   * @return 打开成功返回true，文件无法打开或不属于当前用户等情况返回false
+   */
+  bool open(const std::string &path, size_t slotCount = 4096);
+
+  /**
+   * @brief 解除映射并关闭缓存文件
+   */
+  void close();
+
+  /**
+   * @brief 缓存是否可用
+   */
+  bool isOpen() const { return _slots != nullptr; }
+
+  /**
+   * @brief 计算缓存键
+   * @param licenseCode 许可证代码
+   * @param publicKey 公钥(DER格式)
+   * @param deviceFingerprint 设备指纹
+   * @return 缓存键
+   */
+  static Key makeKey(std::string_view licenseCode, std::string_view publicKey,
+                     std::string_view deviceFingerprint);
+
+  /**
+   * @brief 查询验证结果
+   * @param key 缓存键
+   * @param verdict 输出参数，签名与设备指纹验证是否通过
+   * @param validStart 输出参数，许可证生效时间戳
+   * @param validEnd 输出参数，许可证过期时间戳
+   * @return 命中返回true，未命中返回false
+   */
+  bool lookup(const Key &key, bool &verdict, long long &validStart,
+              long long &validEnd) const;
+
+  /**
+   * @brief 写入验证结果，槽位正被其他进程写入时放弃
+   * @param key 缓存键
+   * @param verdict 签名与设备指纹验证是否通过
+   * @param validStart 许可证生效时间戳
+   * @param validEnd 许可证过期时间戳
+   */
+  void store(const Key &key, bool verdict, long long validStart,
+             long long validEnd);
+
+private:
+  struct Header;
+  struct Slot;
+
+  LicenseCache(const LicenseCache &) = delete;
+  LicenseCache &operator=(const LicenseCache &) = delete;
+
+  Header *_header;
+  Slot *_slots;
+  size_t _slotCount;
+  size_t _mappedSize;
+#ifdef _WIN32
+  void *_file;
+  void *_mapping;
+#else
+  int _fd;
+#endif
+};
+
+#endif // LICENSECACHE_H
@@ -0,0 +1,115 @@
+#include "LicenseInfo.h"
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+// LicenseInfo序列化运算符实现
+void operator<<(std::string &data, const LicenseInfo &info) {
+  std::stringstream os(std::ios::out | std::ios::binary);
+  // 序列化deviceFingerprint
+  uint32_t len = static_cast<uint32_t>(info.deviceFingerprint.size());
+  os.write(reinterpret_cast<const char *>(&len), sizeof(len));
+  os.write(info.deviceFingerprint.data(), len);
+
+  // 序列化validStart
+  os.write(reinterpret_cast<const char *>(&info.validStart),
+           sizeof(info.validStart));
+
+  // 序列化validEnd
+  os.write(reinterpret_cast<const char *>(&info.validEnd),
+           sizeof(info.validEnd));
+
+  // 序列化allowedFeatures
+  uint32_t featureCount = static_cast<uint32_t>(info.allowedFeatures.size());
+  os.write(reinterpret_cast<const char *>(&featureCount), sizeof(featureCount));
+  for (const auto &feature : info.allowedFeatures) {
+    len = static_cast<uint32_t>(feature.size());
+    os.write(reinterpret_cast<const char *>(&len), sizeof(len));
+    os.write(feature.data(), len);
+  }
+  data = os.str();
+  return;
+}
+
+// LicenseInfo反序列化运算符实现
+void operator>>(std::string &data, LicenseInfo &info) {
+  std::stringstream is(data,std::ios::in|std::ios::binary);
+  // 反序列化deviceFingerprint
+  uint32_t len = 0;
+  is.read(reinterpret_cast<char *>(&len), sizeof(len));
+  info.deviceFingerprint.resize(len);
+  is.read(&info.deviceFingerprint[0], len);
+
+  // 反序列化validStart
+  is.read(reinterpret_cast<char *>(&info.validStart), sizeof(info.validStart));
+
+  // 反序列化validEnd
+  is.read(reinterpret_cast<char *>(&info.validEnd), sizeof(info.validEnd));
+
+  // 反序列化allowedFeatures
+  uint32_t featureCount;
+  is.read(reinterpret_cast<char *>(&featureCount), sizeof(featureCount));
+  info.allowedFeatures.resize(featureCount);
+  for (auto &feature : info.allowedFeatures) {
+    is.read(reinterpret_cast<char *>(&len), sizeof(len));
+    feature.resize(len);
+    is.read(&feature[0], len);
+  }
+  return;
+}
+
+// 按序列化格式遍历各长度字段，确认数据恰好完整
+bool LicenseInfo::isWellFormed(std::string_view data) {
+  size_t pos = 0;
+  auto skipBlock = [&](size_t &out) {
+    uint32_t len = 0;
+    if (data.size() - pos < sizeof(len))
+      return false;
+    memcpy(&len, data.data() + pos, sizeof(len));
+    pos += sizeof(len);
+    out = len;
+    return true;
+  };
+  size_t len = 0;
+  if (!skipBlock(len) || data.size() - pos < len)
+    return false;
+  pos += len;
+  if (data.size() - pos < sizeof(long long) * 2)
+    return false;
+  pos += sizeof(long long) * 2;
+  size_t featureCount = 0;
+  if (!skipBlock(featureCount))
+    return false;
+  for (size_t i = 0; i < featureCount; ++i) {
+    if (!skipBlock(len) || data.size() - pos < len)
+      return false;
+    pos += len;
+  }
+  return pos == data.size();
+}
+
+bool PmrLicenseInfo::deserialize(std::string_view data) {
+  if (!LicenseInfo::isWellFormed(data))
+    return false;
+  size_t pos = 0;
+  auto read = [&](void *out, size_t len) {
+    memcpy(out, data.data() + pos, len);
+    pos += len;
+  };
+  // 结构已校验，直接按格式读取
+  uint32_t len = 0;
+  read(&len, sizeof(len));
+  deviceFingerprint.assign(data.data() + pos, len);
+  pos += len;
+  read(&validStart, sizeof(validStart));
+  read(&validEnd, sizeof(validEnd));
+  uint32_t featureCount = 0;
+  read(&featureCount, sizeof(featureCount));
+  allowedFeatures.resize(featureCount);
+  for (auto &feature : allowedFeatures) {
+    read(&len, sizeof(len));
+    feature.assign(data.data() + pos, len);
+    pos += len;
+  }
+  return true;
+}
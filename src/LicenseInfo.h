@@ -0,0 +1,61 @@
+#ifndef LICENSEINFO_H
+#define LICENSEINFO_H
+
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct LicenseInfo {
+  std::string deviceFingerprint;            ///< 设备指纹
+  long long validStart;                     ///< 许可证生效时间戳(秒)
+  long long validEnd;                       ///< 许可证过期时间戳(秒)
+  std::vector<std::string> allowedFeatures; ///< 允许使用的功能列表
+
+  /**
+   * @brief 序列化运算符，将LicenseInfo对象转换为字符串
+   * @param data 输出参数，用于存储序列化后的数据
+   * @param info 待序列化的LicenseInfo对象
+   */
+  friend void operator<<(std::string &data, const LicenseInfo &info);
+  /**
+   * @brief 反序列化运算符，从字符串恢复LicenseInfo对象
+   * @param data 包含序列化数据的字符串
+   * @param info 输出参数，用于存储反序列化后的对象
+   */
+  friend void operator>>(std::string &data, LicenseInfo &info);
+
+  /**
+   * @brief 检查序列化数据的结构是否完整，不分配内存
+   * @param data 序列化后的数据
+   * @return 各长度字段与数据长度一致返回true，否则返回false
+   */
+  static bool isWellFormed(std::string_view data);
+};
+
+/**
+ * @brief 使用memory_resource分配内存的LicenseInfo
+ *
+ * 字符串与功能列表均从构造时指定的memory_resource分配，配合
+ * std::pmr::monotonic_buffer_resource等内存池可使验证过程不使用全局堆。
+ */
+struct PmrLicenseInfo {
+  using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+  std::pmr::string deviceFingerprint;                 ///< 设备指纹
+  long long validStart = 0;                           ///< 许可证生效时间戳(秒)
+  long long validEnd = 0;                             ///< 许可证过期时间戳(秒)
+  std::pmr::vector<std::pmr::string> allowedFeatures; ///< 允许使用的功能列表
+
+  explicit PmrLicenseInfo(allocator_type alloc = {})
+      : deviceFingerprint(alloc), allowedFeatures(alloc) {}
+
+  /**
+   * @brief 从序列化数据恢复对象，格式与LicenseInfo相同
+   * @param data 序列化后的数据
+   * @return 数据结构完整返回true，否则返回false
+   */
+  bool deserialize(std::string_view data);
+};
+
+#endif // LICENSEINFO_H
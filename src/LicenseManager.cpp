@@ -1,12 +1,22 @@
 #include "LicenseManager.h"
 #include "DeviceFingerprint.h"
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include <filesystem>
 #include "Base64.h"
+#ifdef LICENSEMANAGER_EMBEDDED_PUBLIC_KEY
+#include "EmbeddedPublicKey.h"
+#endif
 namespace fs = std::filesystem;
 
 LicenseManager::LicenseManager(const std::string &privateKeyPath,
@@ -15,6 +25,10 @@ LicenseManager::LicenseManager(const std::string &privateKeyPath,
     _crypto.loadPrivateKeyFile(privateKeyPath);
   if (!publicKeyPath.empty())
     _crypto.loadPublicKeyFile(publicKeyPath);
+#ifdef LICENSEMANAGER_EMBEDDED_PUBLIC_KEY
+  else
+    loadEmbeddedPublicKey();
+#endif
 }
 
 std::string LicenseManager::generateLicenseCode(const LicenseInfo &info) {
@@ -28,28 +42,241 @@ std::string LicenseManager::generateLicenseCode(const LicenseInfo &info) {
   return base64_encode(data) + "|" + base64_encode(signature);
 }
 
+// 判断当前时间是否处于许可证有效期内
+static bool isWithinValidity(long long validStart, long long validEnd) {
+  auto now = std::chrono::system_clock::now().time_since_epoch();
+  auto now_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+  return now_ms >= validStart && now_ms <= validEnd;
+}
+
+// verifyLicenseCode使用的解码缓冲区：std::string或从arena分配的std::pmr::string
+static std::string makeStringBuffer() { return std::string(); }
+
+// Base64解码到buffer，不额外分配临时字符串
+template <typename String>
+static void decodeInto(std::string_view encoded, String &buffer) {
+  buffer.resize(base64_decoded_size(encoded.size()));
+  buffer.resize(base64_decode(encoded.data(), encoded.size(), &buffer[0]));
+}
+
+// 按规范格式反序列化许可证信息，格式不规范时返回false
+static bool deserializeInfo(std::string &data, LicenseInfo &info) {
+  if (!LicenseInfo::isWellFormed(data))
+    return false;
+  data >> info;
+  return true;
+}
+static bool deserializeInfo(const std::pmr::string &data, PmrLicenseInfo &info) {
+  return info.deserialize(data);
+}
+
+// 析构时回收所有已启动的线程，创建线程抛出异常时也不会因未join而终止进程
+struct ThreadJoiner {
+  std::vector<std::thread> &threads;
+  ~ThreadJoiner() {
+    for (auto &t : threads)
+      if (t.joinable())
+        t.join();
+  }
+};
+
+// 将许可证代码按'|'拆分为数据和签名两部分，不复制数据
+// 与按'|'逐段getline的结果一致：恰好两段，允许末尾多一个'|'
+static bool splitLicenseCode(std::string_view licenseCode,
+                             std::string_view &dataPart,
+                             std::string_view &signaturePart) {
+  size_t sep = licenseCode.find('|');
+  if (sep == std::string_view::npos || sep + 1 == licenseCode.size())
+    return false;
+  std::string_view rest = licenseCode.substr(sep + 1);
+  size_t end = rest.find('|');
+  if (end != std::string_view::npos && end + 1 != rest.size())
+    return false;
+  dataPart = licenseCode.substr(0, sep);
+  signaturePart = rest.substr(0, end);
+  return true;
+}
+
 bool LicenseManager::verifyLicense(const std::string &licenseCode,
                                    LicenseInfo &info,
                                    const std::string &deviceFingerprint) {
-  std::vector<std::string> parts;
-  std::stringstream ss(licenseCode);
-  std::string item;
-  while (std::getline(ss, item, '|')) {
-    parts.push_back(item);
+  return verifyLicenseCode(licenseCode, &info, deviceFingerprint,
+                           makeStringBuffer);
+}
+
+bool LicenseManager::verifyLicense(std::string_view licenseCode,
+                                   PmrLicenseInfo &info,
+                                   std::string_view deviceFingerprint,
+                                   std::pmr::memory_resource *arena) {
+  if (!arena)
+    arena = std::pmr::get_default_resource();
+  // 解码结果从arena分配
+  return verifyLicenseCode(licenseCode, &info, deviceFingerprint,
+                           [arena] { return std::pmr::string(arena); });
+}
+
+template <typename Info, typename MakeBuffer>
+bool LicenseManager::verifyLicenseCode(std::string_view licenseCode, Info *info,
+                                       std::string_view deviceFingerprint,
+                                       MakeBuffer makeBuffer) {
+  // 共享缓存命中时跳过签名验证；不需要许可证信息时直接使用缓存的有效期
+  LicenseCache::Key key{};
+  bool cached = false;
+  if (_cache.isOpen()) {
+    key = LicenseCache::makeKey(licenseCode, _crypto.publicKeyDer(),
+                                deviceFingerprint);
+    bool verdict = false;
+    long long validStart = 0, validEnd = 0;
+    if (_cache.lookup(key, verdict, validStart, validEnd)) {
+      if (!verdict)
+        return false;
+      if (!info)
+        return isWithinValidity(validStart, validEnd);
+      cached = true;
+    }
   }
-  if (parts.size() != 2)
+
+  std::string_view dataPart, signaturePart;
+  if (!splitLicenseCode(licenseCode, dataPart, signaturePart))
     return false;
-  std::string data = base64_decode(parts[0]);
-  std::string signature = base64_decode(parts[1]);
-  if (!_crypto.verifySignature(data, signature))
+  auto data = makeBuffer();
+  decodeInto(dataPart, data);
+  if (!cached) {
+    auto signature = makeBuffer();
+    decodeInto(signaturePart, signature);
+    auto dataBytes = reinterpret_cast<const unsigned char *>(data.data());
+    auto signatureBytes =
+        reinterpret_cast<const unsigned char *>(signature.data());
+    // 内存池版本不能经过OpenSSL的内存分配
+    bool verified;
+    if constexpr (std::is_same_v<Info, PmrLicenseInfo>)
+      verified = _crypto.verifySignatureNoAlloc(dataBytes, data.size(),
+                                                signatureBytes, signature.size());
+    else
+      verified = _crypto.verifySignature(dataBytes, data.size(), signatureBytes,
+                                         signature.size());
+    if (!verified) {
+      if (_cache.isOpen())
+        _cache.store(key, false, 0, 0);
+      return false;
+    }
+  }
+  // 与批量验证一致：签名正确但数据格式不规范(如带多余字节)的许可证同样拒绝
+  Info parsed;
+  Info &result = info ? *info : parsed;
+  if (!deserializeInfo(data, result)) {
+    if (!cached && _cache.isOpen())
+      _cache.store(key, false, 0, 0);
     return false;
-  data >> info;
-  if (info.deviceFingerprint != deviceFingerprint)
+  }
+  bool matched = std::string_view(result.deviceFingerprint) == deviceFingerprint;
+  if (!cached && _cache.isOpen())
+    _cache.store(key, matched, result.validStart, result.validEnd);
+  if (!matched)
     return false;
-  auto now = std::chrono::system_clock::now().time_since_epoch();
-  auto now_ms =
-      std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
-  return now_ms >= info.validStart && now_ms <= info.validEnd;
+  return isWithinValidity(result.validStart, result.validEnd);
+}
+
+std::vector<LicenseVerifyResult>
+LicenseManager::verifyLicenses(const std::vector<std::string> &licenseCodes,
+                               const std::string &deviceFingerprint) {
+  return verifyLicenses(licenseCodes.data(), licenseCodes.size(),
+                        deviceFingerprint);
+}
+
+std::vector<LicenseVerifyResult>
+LicenseManager::verifyLicenses(const std::string *licenseCodes, size_t count,
+                               const std::string &deviceFingerprint) {
+  // 待验证签名的去重许可证
+  struct Candidate {
+    std::string data;
+    std::string signature;
+    LicenseCache::Key key;
+    LicenseVerifyResult result;
+  };
+
+  // 第一步：去重，记录每个输入对应的去重后序号
+  std::unordered_map<std::string_view, size_t> uniqueIndex;
+  std::vector<size_t> indices(count);
+  std::vector<Candidate> candidates;
+  for (size_t i = 0; i < count; ++i) {
+    auto it = uniqueIndex.emplace(licenseCodes[i], candidates.size());
+    if (it.second)
+      candidates.emplace_back();
+    indices[i] = it.first->second;
+  }
+
+  // 第二步：先做结构、设备指纹、有效期和缓存检查，只有通过的才进行签名验证
+  std::vector<Candidate *> pending;
+  for (auto &entry : uniqueIndex) {
+    Candidate &c = candidates[entry.second];
+    std::string_view licenseCode = entry.first;
+    std::string_view dataPart, signaturePart;
+    if (!splitLicenseCode(licenseCode, dataPart, signaturePart))
+      continue;
+    c.data = base64_decode(dataPart);
+    if (!LicenseInfo::isWellFormed(c.data))
+      continue;
+    LicenseInfo &info = c.result.info;
+    c.data >> info;
+    if (info.deviceFingerprint != deviceFingerprint ||
+        !isWithinValidity(info.validStart, info.validEnd))
+      continue;
+    if (_cache.isOpen()) {
+      c.key = LicenseCache::makeKey(licenseCode, _crypto.publicKeyDer(),
+                                    deviceFingerprint);
+      bool verdict = false;
+      long long validStart = 0, validEnd = 0;
+      if (_cache.lookup(c.key, verdict, validStart, validEnd)) {
+        c.result.valid = verdict;
+        continue;
+      }
+    }
+    c.signature = base64_decode(signaturePart);
+    pending.push_back(&c);
+  }
+
+  // 第三步：多线程并行验证签名(公钥只读共享，每次验证使用独立的上下文)
+  std::atomic<size_t> next{0};
+  auto worker = [&] {
+    for (size_t i = next++; i < pending.size(); i = next++) {
+      Candidate &c = *pending[i];
+      c.result.valid = _crypto.verifySignature(c.data, c.signature);
+      if (_cache.isOpen())
+        _cache.store(c.key, c.result.valid, c.result.info.validStart,
+                     c.result.info.validEnd);
+    }
+  };
+  size_t threadCount = std::min<size_t>(
+      pending.size(), std::max(1u, std::thread::hardware_concurrency()));
+  std::vector<std::thread> threads;
+  ThreadJoiner joiner{threads};
+  threads.reserve(threadCount);
+  for (size_t i = 1; i < threadCount; ++i) {
+    try {
+      threads.emplace_back(worker);
+    } catch (const std::system_error &) {
+      // 无法创建更多线程时由已启动的线程和当前线程完成剩余验证
+      break;
+    }
+  }
+  worker();
+
+  // 按输入顺序输出结果，未通过的不返回许可证信息
+  std::vector<LicenseVerifyResult> results(count);
+  for (size_t i = 0; i < count; ++i) {
+    const LicenseVerifyResult &r = candidates[indices[i]].result;
+    results[i].valid = r.valid;
+    if (r.valid)
+      results[i].info = r.info;
+  }
+  return results;
+}
+
+bool LicenseManager::enableSharedCache(const std::string &path,
+                                       size_t slotCount) {
+  return _cache.open(path, slotCount);
 }
 
 bool LicenseManager::loadPrivateKeyFile(const std::string &path) {
@@ -65,6 +292,17 @@ bool LicenseManager::loadPrivateKeyStr(const std::string &key) {
 bool LicenseManager::loadPublicKeyStr(const std::string &key) {
   return _crypto.loadPublicKeyStr(key);
 }
+bool LicenseManager::loadPublicKeyDer(const unsigned char *der, size_t len) {
+  return _crypto.loadPublicKeyDer(der, len);
+}
+bool LicenseManager::loadEmbeddedPublicKey() {
+#ifdef LICENSEMANAGER_EMBEDDED_PUBLIC_KEY
+  return _crypto.loadPublicKeyDer(embedded_public_key_der,
+                                  embedded_public_key_der_size);
+#else
+  return false;
+#endif
+}
 LicenseManager *LicenseManager::Instance(const std::string &privateKeyPath,
                                          const std::string &publicKeyPath) {
   static LicenseManager instance(privateKeyPath, publicKeyPath);
@@ -131,61 +369,6 @@ bool LicenseManager::loadAndVerifyLicense(const std::string &fileName,
   if (deviceFingerprint.empty()) {
     deviceFingerprint = DeviceFingerprint::generateFingerprint();
   }
-  LicenseInfo info;
-  return verifyLicense(fileData, info, deviceFingerprint);
-}
-
-// LicenseInfo序列化运算符实现
-void operator<<(std::string &data, const LicenseInfo &info) {
-  std::stringstream os(std::ios::out | std::ios::binary);
-  // 序列化deviceFingerprint
-  uint32_t len = static_cast<uint32_t>(info.deviceFingerprint.size());
-  os.write(reinterpret_cast<const char *>(&len), sizeof(len));
-  os.write(info.deviceFingerprint.data(), len);
-
-  // 序列化validStart
-  os.write(reinterpret_cast<const char *>(&info.validStart),
-           sizeof(info.validStart));
-
-  // 序列化validEnd
-  os.write(reinterpret_cast<const char *>(&info.validEnd),
-           sizeof(info.validEnd));
-
-  // 序列化allowedFeatures
-  uint32_t featureCount = static_cast<uint32_t>(info.allowedFeatures.size());
-  os.write(reinterpret_cast<const char *>(&featureCount), sizeof(featureCount));
-  for (const auto &feature : info.allowedFeatures) {
-    len = static_cast<uint32_t>(feature.size());
-    os.write(reinterpret_cast<const char *>(&len), sizeof(len));
-    os.write(feature.data(), len);
-  }
-  data = os.str();
-  return;
-}
-
-// LicenseInfo反序列化运算符实现
-void operator>>(std::string &data, LicenseInfo &info) {
-  std::stringstream is(data,std::ios::in|std::ios::binary);
-  // 反序列化deviceFingerprint
-  uint32_t len = 0;
-  is.read(reinterpret_cast<char *>(&len), sizeof(len));
-  info.deviceFingerprint.resize(len);
-  is.read(&info.deviceFingerprint[0], len);
-
-  // 反序列化validStart
-  is.read(reinterpret_cast<char *>(&info.validStart), sizeof(info.validStart));
-
-  // 反序列化validEnd
-  is.read(reinterpret_cast<char *>(&info.validEnd), sizeof(info.validEnd));
-
-  // 反序列化allowedFeatures
-  uint32_t featureCount;
-  is.read(reinterpret_cast<char *>(&featureCount), sizeof(featureCount));
-  info.allowedFeatures.resize(featureCount);
-  for (auto &feature : info.allowedFeatures) {
-    is.read(reinterpret_cast<char *>(&len), sizeof(len));
-    feature.resize(len);
-    is.read(&feature[0], len);
-  }
-  return;
+  return verifyLicenseCode(fileData, static_cast<LicenseInfo *>(nullptr),
+                           deviceFingerprint, makeStringBuffer);
 }
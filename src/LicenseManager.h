@@ -2,28 +2,18 @@
 #define LICENSEMANAGER_H
 
 #include "Crypto.h"
+#include "LicenseCache.h"
+#include "LicenseInfo.h"
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 
 
-struct LicenseInfo {
-  std::string deviceFingerprint;            ///< 设备指纹
-  long long validStart;                     ///< 许可证生效时间戳(秒)
-  long long validEnd;                       ///< 许可证过期时间戳(秒)
-  std::vector<std::string> allowedFeatures; ///< 允许使用的功能列表
-
-  /**
-   * @brief 序列化运算符，将LicenseInfo对象转换为字符串
-   * @param data 输出参数，用于存储序列化后的数据
-   * @param info 待序列化的LicenseInfo对象
-   */
-  friend void operator<<(std::string &data, const LicenseInfo &info);
-  /**
-   * @brief 反序列化运算符，从字符串恢复LicenseInfo对象
-   * @param data 包含序列化数据的字符串
-   * @param info 输出参数，用于存储反序列化后的对象
-   */
-  friend void operator>>(std::string &data, LicenseInfo &info);
+/// 批量验证中单个许可证的验证结果
+struct LicenseVerifyResult {
+  bool valid = false; ///< 验证是否通过
+  LicenseInfo info{}; ///< 验证通过时的许可证信息
 };
 
 class LicenseManager {
@@ -31,7 +21,7 @@ public:
   /**
    * @brief 获取单例实例
    * @param privateKeyPath 私钥文件路径(可选)
-   * @param publicKeyPath 公钥文件路径(可选)
+   * @param publicKeyPath 公钥文件路径(可选)，为空时使用编译进库中的公钥(如有)
    * @return LicenseManager单例指针
    */
   static LicenseManager *Instance(const std::string &privateKeyPath = "",
@@ -68,6 +58,8 @@ public:
 
   /**
    * @brief 验证许可证的有效性
+   *
+   * 签名数据须为规范格式(LicenseInfo::isWellFormed)，带多余字节的许可证视为无效。
    * @param licenseCode 待验证的许可证代码字符串
    * @param info 用于存储许可证信息的输出参数
    * @param deviceFingerprint 设备指纹字符串，用于绑定设备验证
@@ -76,6 +68,47 @@ public:
   bool verifyLicense(const std::string &licenseCode, LicenseInfo &info,
                      const std::string &deviceFingerprint);
 
+  /**
+   * @brief 验证许可证的有效性，不使用全局堆
+   *
+   * 验证过程中的临时数据从arena分配，许可证信息从info自身的memory_resource分配。
+   * 传入 std::pmr::monotonic_buffer_resource 等内存池并在每次调用后释放，
+   * 即可使稳定状态下的验证不进行全局堆分配。Ed25519公钥的签名由自包含实现验证，不经过OpenSSL，
+   * 整个过程(包括共享缓存)都不分配内存；RSA公钥的验证仍由OpenSSL完成，其内部会分配内存。
+   * @param licenseCode 待验证的许可证代码字符串
+   * @param info 用于存储许可证信息的输出参数
+   * @param deviceFingerprint 设备指纹字符串，用于绑定设备验证
+   * @param arena 临时数据使用的memory_resource，为空时使用默认资源
+   * @return 验证成功返回true，失败返回false
+   */
+  bool verifyLicense(std::string_view licenseCode, PmrLicenseInfo &info,
+                     std::string_view deviceFingerprint,
+                     std::pmr::memory_resource *arena);
+
+  /**
+   * @brief 批量验证许可证
+   *
+   * 相同的许可证代码只验证一次；先进行结构、设备指纹和有效期等低成本检查，
+   * 通过后才进行签名验证，并由多个线程并行完成。验证语义与verifyLicense一致。
+   * @param licenseCodes 待验证的许可证代码数组
+   * @param count 许可证数量
+   * @param deviceFingerprint 设备指纹字符串
+   * @return 与输入顺序一致的验证结果
+   */
+  std::vector<LicenseVerifyResult>
+  verifyLicenses(const std::string *licenseCodes, size_t count,
+                 const std::string &deviceFingerprint);
+
+  /**
+   * @brief 批量验证许可证
+   * @param licenseCodes 待验证的许可证代码列表
+   * @param deviceFingerprint 设备指纹字符串
+   * @return 与输入顺序一致的验证结果
+   */
+  std::vector<LicenseVerifyResult>
+  verifyLicenses(const std::vector<std::string> &licenseCodes,
+                 const std::string &deviceFingerprint);
+
   /**
    * @brief 从文件加载私钥
    * @param path 私钥文件路径
@@ -104,6 +137,29 @@ public:
    */
   bool loadPublicKeyStr(const std::string &key);
 
+  /**
+   * @brief 从DER格式数据加载公钥，跳过PEM的Base64解码
+   * @param der DER编码的公钥(SubjectPublicKeyInfo)
+   * @param len 数据长度
+   * @return 加载成功返回true，失败返回false
+   */
+  bool loadPublicKeyDer(const unsigned char *der, size_t len);
+
+  /**
+   * @brief 加载构建时编译进库中的公钥(LICENSEMANAGER_PUBLIC_KEY_PEM)
+   * @return 加载成功返回true，未嵌入公钥或加载失败返回false
+   */
+  bool loadEmbeddedPublicKey();
+
+  /**
+   * @brief 启用主机内跨进程共享的验证结果缓存(可选)
+   * @param path 缓存文件路径，同一用户的进程使用相同路径即可共享。
+   *             能写入该文件的进程可使任意许可证通过验证，应放在当前用户私有的目录中
+   * @param slotCount 新建缓存时的槽位数量
+   * @return 启用成功返回true，失败返回false(此时不使用缓存)
+   */
+  bool enableSharedCache(const std::string &path, size_t slotCount = 4096);
+
 private:
   // 构造函数改为私有，禁止外部实例化
   LicenseManager(const std::string &privateKeyPath = "",
@@ -115,7 +171,17 @@ private:
   LicenseManager(LicenseManager &&) = delete;
   LicenseManager &operator=(LicenseManager &&) = delete;
 
+  // 两个verifyLicense与loadAndVerifyLicense共用的验证流程：
+  // 缓存查询 -> 拆分 -> 解码 -> 验签 -> 反序列化 -> 设备指纹与有效期检查。
+  // Info为LicenseInfo或PmrLicenseInfo，makeBuffer创建解码缓冲区(std::string或std::pmr::string)；
+  // info为空时不输出许可证信息，缓存命中时可跳过解析
+  template <typename Info, typename MakeBuffer>
+  bool verifyLicenseCode(std::string_view licenseCode, Info *info,
+                         std::string_view deviceFingerprint,
+                         MakeBuffer makeBuffer);
+
   Crypto _crypto;
+  LicenseCache _cache;
 };
 
 #endif // LICENSEMANAGER_H
@@ -0,0 +1,188 @@
+// 自包含Ed25519与SHA-512实现的正确性测试
+//
+// SHA-512: FIPS 180-4 示例("abc"、896位两分组消息、100万个'a')，分段输入覆盖缓冲逻辑。
+// Ed25519: RFC 8032 §7.1 测试向量必须通过；翻转签名或消息的任意一位、
+// 以及非规范的S(S + L)必须被拒绝。
+// 同一源文件编译为两个程序，Ed25519TestNoInt128 定义ED25519_NO_INT128，
+// 测试MSVC使用的分段乘法路径。
+
+#include "Ed25519.h"
+#include "Sha512.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+#if defined(__SIZEOF_INT128__) && !defined(ED25519_NO_INT128)
+const char *ARITHMETIC = "__int128";
+#else
+const char *ARITHMETIC = "分段乘法";
+#endif
+
+std::vector<unsigned char> fromHex(const char *hex) {
+  std::vector<unsigned char> bytes;
+  for (size_t i = 0; hex[i] && hex[i + 1]; i += 2)
+    bytes.push_back(
+        static_cast<unsigned char>(std::stoi(std::string(hex + i, 2), nullptr, 16)));
+  return bytes;
+}
+
+std::string toHex(const unsigned char *data, size_t len) {
+  static const char digits[] = "0123456789abcdef";
+  std::string hex;
+  for (size_t i = 0; i < len; ++i) {
+    hex += digits[data[i] >> 4];
+    hex += digits[data[i] & 0x0F];
+  }
+  return hex;
+}
+
+// ---------------- SHA-512 ----------------
+
+struct ShaCase {
+  const char *name;
+  std::string message;
+  const char *digest;
+};
+
+// 分别一次性输入与按chunk字节分段输入，结果都必须等于期望摘要
+bool checkSha512(const ShaCase &c, size_t chunk) {
+  unsigned char digest[Sha512::DIGEST_SIZE];
+  Sha512 sha;
+  for (size_t pos = 0; pos < c.message.size(); pos += chunk)
+    sha.update(c.message.data() + pos, std::min(chunk, c.message.size() - pos));
+  sha.final(digest);
+  if (toHex(digest, sizeof(digest)) != c.digest) {
+    std::cerr << "SHA-512 " << c.name << " (分段 " << chunk
+              << " 字节): 摘要不正确" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool testSha512() {
+  const ShaCase cases[] = {
+      {"abc", "abc",
+       "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+       "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f"},
+      {"896位", "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+                "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+       "8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa17299aeadb6889018"
+       "501d289e4900f7e4331b99dec4b5433ac7d329eeb6dd26545e96e55b874be909"},
+      {"100万个a", std::string(1000000, 'a'),
+       "e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973eb"
+       "de0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b"},
+  };
+  bool ok = true;
+  for (const ShaCase &c : cases) {
+    size_t whole = c.message.empty() ? 1 : c.message.size();
+    for (size_t chunk : {whole, size_t(1), size_t(127), size_t(129)})
+      ok = checkSha512(c, chunk) && ok;
+  }
+  return ok;
+}
+
+// ---------------- Ed25519 ----------------
+
+struct EdCase {
+  const char *name;
+  const char *publicKey;
+  const char *message;
+  const char *signature;
+};
+
+// RFC 8032 §7.1
+const EdCase ED_CASES[] = {
+    {"TEST 1",
+     "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a", "",
+     "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e06522490155"
+     "5fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b"},
+    {"TEST 2",
+     "3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c", "72",
+     "92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da"
+     "085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00"},
+    {"TEST 3",
+     "fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025",
+     "af82",
+     "6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac"
+     "18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc027beceea1ec40a"},
+    {"TEST SHA(abc)",
+     "ec172b93ad5e563bf4932c70e1245034c35467ef2efd4d64ebf819683467e2bf",
+     "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+     "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f",
+     "dc2a4459e7369633a52b1bf277839a00201009a3efbf3ecb69bea2186c26b589"
+     "09351fc9ac90b3ecfdfbc7c66431e0303dca179c138ac17ad9bef1177331a704"},
+};
+
+// 群的阶L(小端)
+const unsigned char ORDER_L[32] = {
+    0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7,
+    0xa2, 0xde, 0xf9, 0xde, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10};
+
+bool verify(const std::vector<unsigned char> &signature,
+            const std::vector<unsigned char> &message,
+            const std::vector<unsigned char> &publicKey) {
+  return Ed25519::verify(signature.data(), message.data(), message.size(),
+                         publicKey.data());
+}
+
+bool testEd25519(const EdCase &c) {
+  const auto publicKey = fromHex(c.publicKey);
+  const auto message = fromHex(c.message);
+  const auto signature = fromHex(c.signature);
+  bool ok = true;
+  auto fail = [&](const std::string &what) {
+    std::cerr << "Ed25519 " << c.name << ": " << what << std::endl;
+    ok = false;
+  };
+
+  if (!verify(signature, message, publicKey))
+    fail("有效签名验证失败");
+
+  // 翻转签名的每一位(R与S)
+  for (size_t bit = 0; bit < signature.size() * 8; ++bit) {
+    auto forged = signature;
+    forged[bit / 8] ^= static_cast<unsigned char>(1 << (bit % 8));
+    if (verify(forged, message, publicKey)) {
+      fail("翻转签名第" + std::to_string(bit) + "位后验证通过");
+      break;
+    }
+  }
+
+  // 翻转消息的每一位
+  for (size_t bit = 0; bit < message.size() * 8; ++bit) {
+    auto forged = message;
+    forged[bit / 8] ^= static_cast<unsigned char>(1 << (bit % 8));
+    if (verify(signature, forged, publicKey)) {
+      fail("翻转消息第" + std::to_string(bit) + "位后验证通过");
+      break;
+    }
+  }
+
+  // S + L 与S模L同余，非规范编码必须被拒绝(S < L，因此S + L < 2^256)
+  auto malleable = signature;
+  unsigned carry = 0;
+  for (size_t i = 0; i < 32; ++i) {
+    carry += malleable[32 + i] + ORDER_L[i];
+    malleable[32 + i] = static_cast<unsigned char>(carry);
+    carry >>= 8;
+  }
+  if (verify(malleable, message, publicKey))
+    fail("非规范的S(S + L)验证通过");
+
+  return ok;
+}
+
+} // namespace
+
+int main() {
+  std::cout << "Ed25519乘法实现: " << ARITHMETIC << std::endl;
+  bool ok = testSha512();
+  for (const EdCase &c : ED_CASES)
+    ok = testEd25519(c) && ok;
+  std::cout << (ok ? "通过" : "失败") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+// 共享验证缓存的信任边界与并发测试(POSIX)
+//
+// 信任边界：新建的缓存文件权限必须为0600；可被组或其他用户写入的文件、
+// 属于其他用户的文件(需root运行才能构造，否则跳过)以及符号链接都必须被拒绝。
+// 并发：多个进程以不同的槽位数打开同一缓存，对同一组键交替写入两组不同的结果并查询，
+// 命中的结论与有效期必须是某一次完整写入的内容，不能混合两次写入。
+
+#include "LicenseCache.h"
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+namespace fs = std::filesystem;
+
+namespace {
+
+const int PROCESSES = 8;
+const int ROUNDS = 20;
+const int KEYS = 512;
+const int ITERATIONS = 20000;
+
+bool g_ok = true;
+
+void expect(bool condition, const std::string &what) {
+  if (!condition) {
+    std::cerr << what << std::endl;
+    g_ok = false;
+  }
+}
+
+bool canOpen(const fs::path &path) {
+  LicenseCache cache;
+  return cache.open(path.string(), 16);
+}
+
+// 新建缓存：权限为0600，写入的结果在另一个实例中可见
+void testCreate(const fs::path &dir) {
+  fs::path path = dir / "create.cache";
+  LicenseCache writer;
+  expect(writer.open(path.string(), 16), "无法新建缓存文件");
+  struct stat st;
+  expect(stat(path.c_str(), &st) == 0 && (st.st_mode & 0777) == 0600,
+         "新建的缓存文件权限不是0600");
+
+  LicenseCache::Key key = LicenseCache::makeKey("code", "public-key", "fp");
+  writer.store(key, true, 100, 200);
+  LicenseCache reader;
+  bool verdict = false;
+  long long start = 0, end = 0;
+  expect(reader.open(path.string(), 4096) &&
+             reader.lookup(key, verdict, start, end) && verdict &&
+             start == 100 && end == 200,
+         "另一个实例未读到写入的结果");
+  expect(!reader.lookup(LicenseCache::makeKey("code", "public-key", "other"),
+                        verdict, start, end),
+         "设备指纹不同的键命中了缓存");
+}
+
+// 可被组或其他用户写入的文件必须被拒绝
+void testWritableByOthers(const fs::path &dir) {
+  fs::path path = dir / "mode.cache";
+  expect(canOpen(path), "无法新建缓存文件");
+  for (mode_t mode : {mode_t(0666), mode_t(0620), mode_t(0602)}) {
+    chmod(path.c_str(), mode);
+    expect(!canOpen(path), "接受了权限为0" +
+                               std::to_string((mode >> 6) & 7) +
+                               std::to_string((mode >> 3) & 7) +
+                               std::to_string(mode & 7) + "的缓存文件");
+  }
+  chmod(path.c_str(), 0600);
+  expect(canOpen(path), "恢复0600权限后无法打开缓存文件");
+}
+
+// 属于其他用户的文件必须被拒绝，只有root能构造这种文件
+void testOtherOwner(const fs::path &dir) {
+  if (geteuid() != 0) {
+    std::cout << "非root运行，跳过其他用户所有的缓存文件测试" << std::endl;
+    return;
+  }
+  fs::path path = dir / "owner.cache";
+  expect(canOpen(path), "无法新建缓存文件");
+  const uid_t nobody = 65534;
+  expect(chown(path.c_str(), nobody, nobody) == 0, "无法修改缓存文件的所有者");
+  expect(!canOpen(path), "接受了属于其他用户的缓存文件");
+}
+
+// 不跟随符号链接：指向已有缓存或不存在的文件都必须被拒绝，且不能创建链接目标
+void testSymlink(const fs::path &dir) {
+  fs::path target = dir / "target.cache";
+  fs::path link = dir / "link.cache";
+  expect(canOpen(target), "无法新建缓存文件");
+  fs::create_symlink(target, link);
+  expect(!canOpen(link), "跟随了指向缓存文件的符号链接");
+
+  fs::path missing = dir / "missing.cache";
+  fs::path dangling = dir / "dangling.cache";
+  fs::create_symlink(missing, dangling);
+  expect(!canOpen(dangling), "跟随了悬空的符号链接");
+  expect(!fs::exists(missing), "通过悬空的符号链接创建了目标文件");
+}
+
+// 每个键有两组结果，写入方交替写入，读取方命中时必须得到其中完整的一组
+struct Entry {
+  bool verdict;
+  long long validStart;
+  long long validEnd;
+};
+
+Entry entryFor(int key, int variant) {
+  long long base = 1700000000LL + key * 1000LL;
+  return variant == 0 ? Entry{true, base, base + 86400}
+                      : Entry{false, -base, base * 2};
+}
+
+// 子进程：随机查询与写入，返回读到不一致结果的次数
+int runWorker(const fs::path &path, int worker) {
+  LicenseCache cache;
+  // 新建文件的槽位数由先打开的进程决定，少槽位时同一槽位会被不同的键争用
+  if (!cache.open(path.string(), worker % 2 ? 16 : 4096))
+    return -1;
+  int bad = 0;
+  unsigned state = 2463534242u + worker;
+  for (int i = 0; i < ITERATIONS; ++i) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    int key = static_cast<int>(state % KEYS);
+    LicenseCache::Key cacheKey =
+        LicenseCache::makeKey("code-" + std::to_string(key), "public-key", "fp");
+    bool verdict = false;
+    long long start = 0, end = 0;
+    if (state & 0x10000) {
+      Entry e = entryFor(key, (state >> 17) & 1);
+      cache.store(cacheKey, e.verdict, e.validStart, e.validEnd);
+    } else if (cache.lookup(cacheKey, verdict, start, end)) {
+      Entry a = entryFor(key, 0), b = entryFor(key, 1);
+      bool matchA = verdict == a.verdict && start == a.validStart && end == a.validEnd;
+      bool matchB = verdict == b.verdict && start == b.validStart && end == b.validEnd;
+      if (!matchA && !matchB)
+        bad++;
+    }
+  }
+  return bad;
+}
+
+void testConcurrent(const fs::path &dir) {
+  for (int round = 0; round < ROUNDS; ++round) {
+    fs::path path = dir / ("concurrent-" + std::to_string(round) + ".cache");
+    for (int worker = 0; worker < PROCESSES; ++worker) {
+      pid_t pid = fork();
+      if (pid == 0) {
+        int bad = runWorker(path, worker);
+        _exit(bad < 0 ? 2 : (bad > 0 ? 1 : 0));
+      }
+      expect(pid > 0, "无法创建子进程");
+    }
+    int status = 0;
+    while (wait(&status) > 0) {
+      if (!WIFEXITED(status) || WEXITSTATUS(status) == 1)
+        expect(false, "第" + std::to_string(round + 1) + "轮并发读到不一致的结果");
+      else if (WEXITSTATUS(status) != 0)
+        expect(false, "第" + std::to_string(round + 1) + "轮并发无法打开缓存");
+    }
+  }
+}
+
+} // namespace
+
+int main() {
+  std::string buffer =
+      (fs::temp_directory_path() / "LicenseCacheTest-XXXXXX").string();
+  if (!mkdtemp(&buffer[0])) {
+    std::cerr << "无法创建临时目录" << std::endl;
+    return 1;
+  }
+  fs::path dir = buffer;
+
+  testCreate(dir);
+  testWritableByOthers(dir);
+  testOtherOwner(dir);
+  testSymlink(dir);
+  testConcurrent(dir);
+
+  std::error_code ec;
+  fs::remove_all(dir, ec);
+  std::cout << (g_ok ? "通过" : "失败") << std::endl;
+  return g_ok ? 0 : 1;
+}
@@ -0,0 +1,257 @@
+// 验证路径堆分配测试
+//
+// 替换全局operator new，并通过CRYPTO_set_mem_functions统计OpenSSL内部的分配，
+// 检查使用std::pmr内存池的verifyLicense在稳定状态下不进行任何全局堆分配。
+// 密钥在进程内生成，不依赖外部文件。测试链接静态库：Windows下exe替换的
+// operator new无法统计DLL内部的分配。
+//
+// Ed25519公钥：内存池路径(包括共享缓存)每次验证的分配次数必须为0。
+// RSA公钥：签名由OpenSSL验证，只检查结果并输出分配次数。
+
+#include "LicenseManager.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <string_view>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/rsa.h>
+namespace fs = std::filesystem;
+
+namespace {
+std::atomic<size_t> g_allocations{0};
+std::atomic<size_t> g_opensslAllocations{0};
+
+// 分配与释放放在不内联的函数中，避免GCC在内联后将operator new返回的指针
+// 与std::free视为不匹配(-Wmismatched-new-delete)
+#if defined(__GNUC__)
+#define NOINLINE __attribute__((noinline))
+#else
+#define NOINLINE
+#endif
+
+NOINLINE void *countedAlloc(size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(size ? size : 1);
+}
+NOINLINE void countedFree(void *p) { std::free(p); }
+
+void *opensslMalloc(size_t size, const char *, int) {
+  g_opensslAllocations.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(size);
+}
+void *opensslRealloc(void *p, size_t size, const char *, int) {
+  g_opensslAllocations.fetch_add(1, std::memory_order_relaxed);
+  return std::realloc(p, size);
+}
+void opensslFree(void *p, const char *, int) { std::free(p); }
+} // namespace
+
+void *operator new(size_t size) {
+  if (void *p = countedAlloc(size))
+    return p;
+  throw std::bad_alloc();
+}
+void *operator new[](size_t size) { return operator new(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return countedAlloc(size);
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return countedAlloc(size);
+}
+void operator delete(void *p) noexcept { countedFree(p); }
+void operator delete[](void *p) noexcept { countedFree(p); }
+void operator delete(void *p, size_t) noexcept { countedFree(p); }
+void operator delete[](void *p, size_t) noexcept { countedFree(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+  countedFree(p);
+}
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+  countedFree(p);
+}
+
+namespace {
+
+const int ITERATIONS = 200;
+
+// 在进程内生成密钥对，以PEM格式输出
+bool generateKeyPair(int type, std::string &privatePem, std::string &publicPem) {
+  EVP_PKEY_CTX *ctx = EVP_PKEY_CTX_new_id(type, nullptr);
+  EVP_PKEY *key = nullptr;
+  bool ok = ctx && EVP_PKEY_keygen_init(ctx) == 1 &&
+            (type != EVP_PKEY_RSA ||
+             EVP_PKEY_CTX_set_rsa_keygen_bits(ctx, 2048) == 1) &&
+            EVP_PKEY_keygen(ctx, &key) == 1;
+  EVP_PKEY_CTX_free(ctx);
+  if (!ok)
+    return false;
+  auto toString = [](BIO *bio) {
+    char *data = nullptr;
+    long len = BIO_get_mem_data(bio, &data);
+    std::string result(data, static_cast<size_t>(len));
+    BIO_free(bio);
+    return result;
+  };
+  BIO *priv = BIO_new(BIO_s_mem());
+  BIO *pub = BIO_new(BIO_s_mem());
+  ok = priv && pub &&
+       PEM_write_bio_PrivateKey(priv, key, nullptr, nullptr, 0, nullptr,
+                                nullptr) == 1 &&
+       PEM_write_bio_PUBKEY(pub, key) == 1;
+  EVP_PKEY_free(key);
+  if (ok) {
+    privatePem = toString(priv);
+    publicPem = toString(pub);
+  } else {
+    BIO_free(priv);
+    BIO_free(pub);
+  }
+  return ok;
+}
+
+struct CaseResult {
+  int failures = 0;        ///< 验证结果不正确的次数
+  size_t allocations = 0;  ///< 全局operator new次数
+  size_t opensslAllocs = 0; ///< OpenSSL内部分配次数
+};
+
+// 预热后运行ITERATIONS次内存池验证，检查每次的结果并统计分配
+CaseResult runPmrCase(LicenseManager *manager, const std::string &licenseCode,
+                      const std::string &fingerprint) {
+  // 静态缓冲区作为内存池，上游为null_memory_resource，超出即抛出异常
+  alignas(std::max_align_t) static char buffer[16 * 1024];
+  auto verify = [&] {
+    std::pmr::monotonic_buffer_resource arena(
+        buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    PmrLicenseInfo info(&arena);
+    return manager->verifyLicense(licenseCode, info, fingerprint, &arena) &&
+           std::string_view(info.deviceFingerprint) == fingerprint &&
+           info.allowedFeatures.size() == 3;
+  };
+  CaseResult result;
+  if (!verify())
+    result.failures++;
+  size_t before = g_allocations.load();
+  size_t opensslBefore = g_opensslAllocations.load();
+  for (int i = 0; i < ITERATIONS; ++i) {
+    if (!verify())
+      result.failures++;
+  }
+  result.allocations = g_allocations.load() - before;
+  result.opensslAllocs = g_opensslAllocations.load() - opensslBefore;
+  return result;
+}
+
+// 一种密钥类型的测试数据，密钥与许可证均在进程内生成
+struct KeyCase {
+  const char *name;
+  int type;
+  bool requireNoAlloc; ///< 是否要求稳定状态下没有任何分配
+  std::string privatePem;
+  std::string publicPem;
+  std::string licenseCode;
+};
+
+const char *FINGERPRINT = "test-device-fingerprint";
+
+bool prepare(LicenseManager *manager, KeyCase &c) {
+  if (!generateKeyPair(c.type, c.privatePem, c.publicPem) ||
+      !manager->loadPrivateKeyStr(c.privatePem) ||
+      !manager->loadPublicKeyStr(c.publicPem)) {
+    std::cerr << c.name << ": 生成或加载密钥失败" << std::endl;
+    return false;
+  }
+  LicenseInfo source;
+  source.deviceFingerprint = FINGERPRINT;
+  source.validStart = 0;
+  source.validEnd = 0x7FFFFFFFFFFFFFFFLL;
+  source.allowedFeatures = {"feature-export", "feature-report", "feature-sync"};
+  c.licenseCode = manager->generateLicenseCode(source);
+  if (c.licenseCode.empty()) {
+    std::cerr << c.name << ": 生成许可证失败" << std::endl;
+    return false;
+  }
+
+  bool ok = true;
+  LicenseInfo info;
+  if (!manager->verifyLicense(c.licenseCode, info, FINGERPRINT)) {
+    std::cerr << c.name << ": verifyLicense验证失败" << std::endl;
+    ok = false;
+  }
+  // 篡改后的许可证必须被拒绝
+  std::string tampered = c.licenseCode;
+  tampered[tampered.find('|') / 2] ^= 1;
+  std::pmr::monotonic_buffer_resource arena;
+  PmrLicenseInfo pmrInfo(&arena);
+  if (manager->verifyLicense(tampered, pmrInfo, FINGERPRINT, &arena)) {
+    std::cerr << c.name << ": 篡改的许可证通过了验证" << std::endl;
+    ok = false;
+  }
+  return ok;
+}
+
+// 加载该密钥类型的公钥，运行内存池验证并检查结果与分配次数
+bool check(LicenseManager *manager, const KeyCase &c, const char *label) {
+  if (!manager->loadPublicKeyStr(c.publicPem))
+    return false;
+  CaseResult r = runPmrCase(manager, c.licenseCode, FINGERPRINT);
+  std::cout << c.name << " " << label << ": 失败 " << r.failures
+            << " 次, 分配 " << r.allocations << " 次, OpenSSL分配 "
+            << r.opensslAllocs << " 次 (" << ITERATIONS << " 次验证)"
+            << std::endl;
+  bool ok = true;
+  if (r.failures != 0) {
+    std::cerr << c.name << " " << label << ": 验证结果不正确" << std::endl;
+    ok = false;
+  }
+  if (c.requireNoAlloc && (r.allocations != 0 || r.opensslAllocs != 0)) {
+    std::cerr << c.name << " " << label << ": 稳定状态下出现堆分配" << std::endl;
+    ok = false;
+  }
+  return ok;
+}
+
+} // namespace
+
+int main() {
+  // 必须在OpenSSL进行任何分配之前设置
+  if (CRYPTO_set_mem_functions(opensslMalloc, opensslRealloc, opensslFree) != 1) {
+    std::cerr << "无法设置OpenSSL内存函数" << std::endl;
+    return 1;
+  }
+  LicenseManager *manager = LicenseManager::Instance();
+  KeyCase cases[] = {{"ed25519", EVP_PKEY_ED25519, true, {}, {}, {}},
+                     {"rsa", EVP_PKEY_RSA, false, {}, {}, {}}};
+  bool ok = true;
+  for (KeyCase &c : cases)
+    ok = prepare(manager, c) && ok;
+  if (!ok)
+    return 1;
+  for (const KeyCase &c : cases)
+    ok = check(manager, c, "pmr") && ok;
+
+  // 启用共享缓存后(命中路径)同样检查
+  fs::path cachePath =
+      fs::temp_directory_path() /
+      ("LicenseManagerVerifyAllocTest-" +
+       std::to_string(
+           std::chrono::steady_clock::now().time_since_epoch().count()) +
+       ".cache");
+  if (!manager->enableSharedCache(cachePath.u8string(), 64)) {
+    std::cerr << "启用共享缓存失败" << std::endl;
+    ok = false;
+  } else {
+    for (const KeyCase &c : cases)
+      ok = check(manager, c, "pmr+cache") && ok;
+  }
+  std::error_code ec;
+  fs::remove(cachePath, ec);
+  std::cout << (ok ? "通过" : "失败") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+// 批量验证与单个验证的一致性测试
+//
+// verifyLicenses对每个输入的结论和许可证信息必须与逐个调用verifyLicense相同，
+// 结果按输入顺序返回。输入包含重复的许可证、已过期的许可证、设备指纹不匹配、
+// 伪造的签名、格式错误的许可证、末尾带'|'的许可证，以及签名覆盖了多余字节的数据。
+// 分别在不启用与启用共享缓存(第二次为命中路径)的情况下检查。
+
+#include "Base64.h"
+#include "Crypto.h"
+#include "LicenseManager.h"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+namespace fs = std::filesystem;
+
+namespace {
+
+const char *FINGERPRINT = "test-device-fingerprint";
+
+// 在进程内生成Ed25519密钥对，以PEM格式输出
+bool generateKeyPair(std::string &privatePem, std::string &publicPem) {
+  EVP_PKEY_CTX *ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_ED25519, nullptr);
+  EVP_PKEY *key = nullptr;
+  bool ok = ctx && EVP_PKEY_keygen_init(ctx) == 1 &&
+            EVP_PKEY_keygen(ctx, &key) == 1;
+  EVP_PKEY_CTX_free(ctx);
+  if (!ok)
+    return false;
+  auto toString = [](BIO *bio) {
+    char *data = nullptr;
+    long len = BIO_get_mem_data(bio, &data);
+    std::string result(data, static_cast<size_t>(len));
+    BIO_free(bio);
+    return result;
+  };
+  BIO *priv = BIO_new(BIO_s_mem());
+  BIO *pub = BIO_new(BIO_s_mem());
+  ok = priv && pub &&
+       PEM_write_bio_PrivateKey(priv, key, nullptr, nullptr, 0, nullptr,
+                                nullptr) == 1 &&
+       PEM_write_bio_PUBKEY(pub, key) == 1;
+  EVP_PKEY_free(key);
+  if (ok) {
+    privatePem = toString(priv);
+    publicPem = toString(pub);
+  } else {
+    BIO_free(priv);
+    BIO_free(pub);
+  }
+  return ok;
+}
+
+// 有效期使用毫秒时间戳
+long long nowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+LicenseInfo makeInfo(const std::string &fingerprint, long long validStart,
+                     long long validEnd, const std::string &feature) {
+  LicenseInfo info;
+  info.deviceFingerprint = fingerprint;
+  info.validStart = validStart;
+  info.validEnd = validEnd;
+  info.allowedFeatures = {"feature-base", feature};
+  return info;
+}
+
+bool sameInfo(const LicenseInfo &a, const LicenseInfo &b) {
+  return a.deviceFingerprint == b.deviceFingerprint &&
+         a.validStart == b.validStart && a.validEnd == b.validEnd &&
+         a.allowedFeatures == b.allowedFeatures;
+}
+
+struct TestCode {
+  std::string name;
+  std::string code;
+  bool expectValid;
+};
+
+// 构造各类许可证，expectValid为单个验证应得到的结论
+bool buildCodes(LicenseManager *manager, const std::string &privatePem,
+                std::vector<TestCode> &codes) {
+  long long now = nowMs();
+  long long day = 24LL * 3600 * 1000;
+  auto generate = [&](const LicenseInfo &info) {
+    return manager->generateLicenseCode(info);
+  };
+
+  // 多个有效许可证，数量超过线程数以覆盖多线程验证
+  for (int i = 0; i < 64; ++i)
+    codes.push_back({"有效#" + std::to_string(i),
+                     generate(makeInfo(FINGERPRINT, now - day, now + day,
+                                       "feature-" + std::to_string(i))),
+                     true});
+  std::string valid = codes[0].code;
+
+  codes.push_back({"已过期",
+                   generate(makeInfo(FINGERPRINT, now - 2 * day, now - day,
+                                     "expired")),
+                   false});
+  codes.push_back({"尚未生效",
+                   generate(makeInfo(FINGERPRINT, now + day, now + 2 * day,
+                                     "future")),
+                   false});
+  codes.push_back({"设备指纹不匹配",
+                   generate(makeInfo("other-device", now - day, now + day,
+                                     "other")),
+                   false});
+
+  // 伪造签名：数据部分换成另一份许可证，签名保留原许可证的
+  size_t sep = valid.find('|');
+  std::string other = codes[1].code;
+  codes.push_back({"伪造签名(替换数据)",
+                   other.substr(0, other.find('|')) + valid.substr(sep), false});
+  std::string flipped = valid;
+  flipped[sep + 5] = flipped[sep + 5] == 'A' ? 'B' : 'A';
+  codes.push_back({"伪造签名(修改签名)", flipped, false});
+
+  codes.push_back({"缺少分隔符", valid.substr(0, sep), false});
+  codes.push_back({"缺少签名", valid.substr(0, sep + 1), false});
+  codes.push_back({"空字符串", "", false});
+  codes.push_back({"非Base64数据", "!!!!|" + valid.substr(sep + 1), false});
+  codes.push_back({"末尾一个'|'", valid + "|", true});
+  codes.push_back({"末尾两个'|'", valid + "||", false});
+  codes.push_back({"三段", valid + "|" + valid.substr(sep + 1), false});
+
+  // 签名覆盖了序列化数据之后的多余字节：签名有效，但数据不是规范的序列化结果
+  Crypto signer;
+  if (!signer.loadPrivateKeyStr(privatePem))
+    return false;
+  std::string data;
+  data << makeInfo(FINGERPRINT, now - day, now + day, "trailing");
+  data += "extra";
+  std::string signature = signer.signData(data);
+  codes.push_back({"签名数据末尾有多余字节",
+                   base64_encode(data) + "|" + base64_encode(signature),
+                   false});
+
+  for (const TestCode &c : codes) {
+    if (c.expectValid && c.code.empty()) {
+      std::cerr << "生成许可证失败" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// 批量验证一组输入(含重复)，与逐个验证比较并检查预期结论
+bool check(LicenseManager *manager, const std::vector<TestCode> &codes,
+           const char *label) {
+  // 每个许可证出现两次，重复项不相邻，且部分重复项在其他许可证之间
+  std::vector<size_t> order;
+  for (size_t i = 0; i < codes.size(); ++i)
+    order.push_back(i);
+  for (size_t i = codes.size(); i-- > 0;)
+    order.push_back(i);
+  order.push_back(0);
+
+  std::vector<std::string> input;
+  for (size_t i : order)
+    input.push_back(codes[i].code);
+  std::vector<LicenseVerifyResult> results =
+      manager->verifyLicenses(input, FINGERPRINT);
+  if (results.size() != input.size()) {
+    std::cerr << label << ": 结果数量 " << results.size() << " 与输入数量 "
+              << input.size() << " 不一致" << std::endl;
+    return false;
+  }
+
+  bool ok = true;
+  for (size_t i = 0; i < input.size(); ++i) {
+    const TestCode &c = codes[order[i]];
+    LicenseInfo single;
+    bool singleValid = manager->verifyLicense(c.code, single, FINGERPRINT);
+    const LicenseVerifyResult &r = results[i];
+    std::string where = std::string(label) + " 第" + std::to_string(i) +
+                        "项(" + c.name + ")";
+    if (singleValid != c.expectValid) {
+      std::cerr << where << ": 单个验证结论为 " << singleValid << std::endl;
+      ok = false;
+    }
+    if (r.valid != singleValid) {
+      std::cerr << where << ": 批量验证结论 " << r.valid
+                << " 与单个验证不一致" << std::endl;
+      ok = false;
+    } else if (r.valid && !sameInfo(r.info, single)) {
+      // 许可证信息对应的功能各不相同，顺序错位时会在此发现
+      std::cerr << where << ": 批量验证返回的许可证信息与单个验证不一致"
+                << std::endl;
+      ok = false;
+    } else if (!r.valid && !sameInfo(r.info, LicenseInfo{})) {
+      std::cerr << where << ": 未通过的许可证返回了许可证信息" << std::endl;
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+} // namespace
+
+int main() {
+  LicenseManager *manager = LicenseManager::Instance();
+  std::string privatePem, publicPem;
+  if (!generateKeyPair(privatePem, publicPem) ||
+      !manager->loadPrivateKeyStr(privatePem) ||
+      !manager->loadPublicKeyStr(publicPem)) {
+    std::cerr << "生成或加载密钥失败" << std::endl;
+    return 1;
+  }
+  std::vector<TestCode> codes;
+  if (!buildCodes(manager, privatePem, codes))
+    return 1;
+
+  bool ok = check(manager, codes, "无缓存");
+
+  // 启用共享缓存：第一次写入缓存，第二次走命中路径
+  fs::path cachePath =
+      fs::temp_directory_path() /
+      ("LicenseManagerVerifyLicensesTest-" +
+       std::to_string(
+           std::chrono::steady_clock::now().time_since_epoch().count()) +
+       ".cache");
+  if (!manager->enableSharedCache(cachePath.u8string(), 256)) {
+    std::cerr << "启用共享缓存失败" << std::endl;
+    ok = false;
+  } else {
+    ok = check(manager, codes, "缓存写入") && ok;
+    ok = check(manager, codes, "缓存命中") && ok;
+  }
+  std::error_code ec;
+  fs::remove(cachePath, ec);
+  std::cout << (ok ? "通过" : "失败") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/**
+ * @brief 有界阻塞队列，用于流水线各阶段之间传递数据
+ *
+ * 队列满时push阻塞，形成背压，保证无论输入多大内存占用都保持平稳。
+ * 支持多个生产者：每个生产者结束时调用close()，最后一个生产者关闭后
+ * 消费者在取空队列后pop返回false。
+ */
+template <typename T> class BoundedQueue {
+public:
+  /**
+   * @param capacity 队列容量
+   * @param producers 生产者数量，全部close()后队列才真正关闭
+   */
+  explicit BoundedQueue(size_t capacity, size_t producers = 1)
+      : _capacity(capacity ? capacity : 1), _producers(producers) {}
+
+  BoundedQueue(const BoundedQueue &) = delete;
+  BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+  /**
+   * @brief 入队，队列满时阻塞
+   * @return 队列已关闭返回false
+   */
+  bool push(T item) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _notFull.wait(lock, [this] { return _items.size() < _capacity || _closed; });
+    if (_closed)
+      return false;
+    _items.push_back(std::move(item));
+    lock.unlock();
+    _notEmpty.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief 出队，队列空时阻塞
+   * @return 队列已关闭且已取空返回false
+   */
+  bool pop(T &item) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _notEmpty.wait(lock, [this] { return !_items.empty() || _closed; });
+    if (_items.empty())
+      return false;
+    item = std::move(_items.front());
+    _items.pop_front();
+    lock.unlock();
+    _notFull.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief 一个生产者结束，所有生产者结束后唤醒全部等待者
+   */
+  void close() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_producers > 0 && --_producers > 0)
+      return;
+    _closed = true;
+    _notEmpty.notify_all();
+    _notFull.notify_all();
+  }
+
+private:
+  std::mutex _mutex;
+  std::condition_variable _notEmpty;
+  std::condition_variable _notFull;
+  std::deque<T> _items;
+  size_t _capacity;
+  size_t _producers;
+  bool _closed = false;
+};
+
+#endif // BOUNDEDQUEUE_H
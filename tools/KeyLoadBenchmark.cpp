@@ -0,0 +1,107 @@
+// 公钥加载启动延迟基准测试
+//
+// 对比三种加载公钥的方式在进程启动阶段的耗时:
+//   1. 读取PEM文件 (loadPublicKeyFile)
+//   2. 从内存中的PEM字符串加载 (loadPublicKeyStr)
+//   3. 从内存中的DER字节加载 (loadPublicKeyDer，等同于编译进程序的公钥)
+// 每次迭代都构造新的Crypto对象，计入构造函数中的初始化开销。
+//
+// 用法: KeyLoadBenchmark public.pem [iterations]
+
+#include "Crypto.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <openssl/x509.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMicros(Clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start)
+      .count();
+}
+
+// 运行iterations次并输出首次耗时与平均耗时
+bool runCase(const char *name, int iterations,
+             const std::function<bool(Crypto &)> &load) {
+  double first = 0, total = 0;
+  for (int i = 0; i < iterations; ++i) {
+    auto start = Clock::now();
+    Crypto crypto;
+    if (!load(crypto)) {
+      std::cerr << name << ": 加载公钥失败" << std::endl;
+      return false;
+    }
+    double us = elapsedMicros(start);
+    if (i == 0)
+      first = us;
+    total += us;
+  }
+  std::cout << std::left << std::setw(12) << name << std::right << std::fixed
+            << std::setprecision(2) << "首次 " << std::setw(10) << first
+            << " us    平均 " << std::setw(10) << total / iterations << " us"
+            << std::endl;
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "用法: KeyLoadBenchmark public.pem [iterations]" << std::endl;
+    return 1;
+  }
+  const std::string path = argv[1];
+  const int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 1000;
+
+  // 首个Crypto对象承担进程级的库初始化开销
+  auto start = Clock::now();
+  Crypto init;
+  std::cout << "库初始化     " << std::fixed << std::setprecision(2)
+            << elapsedMicros(start) << " us" << std::endl;
+
+  std::ifstream file(path, std::ios::binary);
+  std::string pem((std::istreambuf_iterator<char>(file)),
+                  std::istreambuf_iterator<char>());
+  if (pem.empty() || !init.loadPublicKeyStr(pem)) {
+    std::cerr << "无法读取公钥: " << path << std::endl;
+    return 1;
+  }
+
+  // 将公钥转换为DER格式，模拟编译进程序的字节数组
+  std::vector<unsigned char> der;
+  {
+    BIO *bio = BIO_new_mem_buf(pem.c_str(), -1);
+    EVP_PKEY *key = PEM_read_bio_PUBKEY(bio, nullptr, nullptr, nullptr);
+    BIO_free(bio);
+    int len = key ? i2d_PUBKEY(key, nullptr) : -1;
+    if (len <= 0) {
+      EVP_PKEY_free(key);
+      std::cerr << "转换DER失败" << std::endl;
+      return 1;
+    }
+    der.resize(len);
+    unsigned char *p = der.data();
+    i2d_PUBKEY(key, &p);
+    EVP_PKEY_free(key);
+  }
+
+  std::cout << "迭代次数     " << iterations << std::endl;
+  bool ok = runCase("pem-file", iterations,
+                    [&](Crypto &c) { return c.loadPublicKeyFile(path); }) &&
+            runCase("pem-string", iterations,
+                    [&](Crypto &c) { return c.loadPublicKeyStr(pem); }) &&
+            runCase("der", iterations, [&](Crypto &c) {
+              return c.loadPublicKeyDer(der.data(), der.size());
+            });
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,718 @@
+// 流水线式批量签发许可证工具
+//
+// 从JSONL或CSV流式读取LicenseInfo记录，按
+//   读取 -> 解析 -> 序列化 -> 签名 -> Base64 -> 写出
+// 的顺序以重叠的流水线阶段处理，各阶段之间使用有界队列连接，
+// 使I/O、解析与RSA签名并发进行，且内存占用与输入规模无关。
+//
+// 用法:
+//   LicenseIssuer --key private.pem [--input file|-] [--format jsonl|csv]
+//                 (--out licenses.idx | --out-dir dir)
+//                 [--threads N] [--queue N]
+//
+// JSONL每行一个对象:
+//   {"deviceFingerprint":"...","validStart":0,"validEnd":0,
+//    "allowedFeatures":["a","b"]}
+// CSV每行: deviceFingerprint,validStart,validEnd,feature1;feature2
+//
+// 输出为索引文件时每行为 "序号\t设备指纹\t许可证代码"；
+// 输出为目录时每条许可证写入 "<序号>.lic"，并生成 index.tsv。
+
+#include "Base64.h"
+#include "BoundedQueue.h"
+#include "Crypto.h"
+#include "LicenseManager.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+namespace fs = std::filesystem;
+
+namespace {
+
+enum class InputFormat { Auto, Jsonl, Csv };
+
+struct Options {
+  std::string keyPath;
+  std::string inputPath = "-";
+  std::string outFile;
+  std::string outDir;
+  InputFormat format = InputFormat::Auto;
+  size_t threads = 0;
+  size_t queueCapacity = 256;
+};
+
+// 在流水线各阶段间流动的记录
+struct Record {
+  uint64_t index = 0;     ///< 输入中的记录序号(从0开始)
+  uint64_t lineNo = 0;    ///< 输入行号(用于错误提示)
+  std::string line;       ///< 原始输入行
+  LicenseInfo info{};     ///< 解析结果
+  std::string data;       ///< 序列化后的数据
+  std::string signature;  ///< 签名
+  std::string code;       ///< 许可证代码
+  bool failed = false;    ///< 某一阶段处理失败，写出阶段只跳过其序号
+};
+
+struct Stats {
+  std::atomic<uint64_t> read{0};
+  std::atomic<uint64_t> written{0};
+  std::atomic<uint64_t> failed{0};
+};
+
+void printUsage() {
+  std::cerr << "用法: LicenseIssuer --key private.pem [--input file|-] "
+               "[--format jsonl|csv]\n"
+               "                     (--out licenses.idx | --out-dir dir) "
+               "[--threads N] [--queue N]"
+            << std::endl;
+}
+
+bool parseOptions(int argc, char *argv[], Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto next = [&](std::string &value) {
+      if (i + 1 >= argc) {
+        std::cerr << "缺少参数值: " << arg << std::endl;
+        return false;
+      }
+      value = argv[++i];
+      return true;
+    };
+    std::string value;
+    if (arg == "--key") {
+      if (!next(opt.keyPath))
+        return false;
+    } else if (arg == "--input") {
+      if (!next(opt.inputPath))
+        return false;
+    } else if (arg == "--out") {
+      if (!next(opt.outFile))
+        return false;
+    } else if (arg == "--out-dir") {
+      if (!next(opt.outDir))
+        return false;
+    } else if (arg == "--format") {
+      if (!next(value))
+        return false;
+      if (value == "jsonl")
+        opt.format = InputFormat::Jsonl;
+      else if (value == "csv")
+        opt.format = InputFormat::Csv;
+      else {
+        std::cerr << "未知输入格式: " << value << std::endl;
+        return false;
+      }
+    } else if (arg == "--threads") {
+      if (!next(value))
+        return false;
+      opt.threads = std::strtoul(value.c_str(), nullptr, 10);
+    } else if (arg == "--queue") {
+      if (!next(value))
+        return false;
+      opt.queueCapacity = std::strtoul(value.c_str(), nullptr, 10);
+    } else {
+      std::cerr << "未知参数: " << arg << std::endl;
+      return false;
+    }
+  }
+  if (opt.keyPath.empty() || opt.outFile.empty() == opt.outDir.empty()) {
+    return false;
+  }
+  if (opt.threads == 0) {
+    opt.threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  return true;
+}
+
+// ---------------- JSONL解析 ----------------
+// 仅支持许可证记录所需的子集：对象、字符串、整数、字符串数组
+
+// 解析十进制时间戳，超出long long范围时拒绝(strtoll会截断为LLONG_MAX/LLONG_MIN)
+bool parseTimestamp(const char *begin, char *&end, long long &out) {
+  errno = 0;
+  out = std::strtoll(begin, &end, 10);
+  return end != begin && errno != ERANGE;
+}
+
+// 设备指纹写入以制表符分隔的索引文件，不能包含制表符或换行符
+bool isIndexSafe(const std::string &field) {
+  return field.find_first_of("\t\r\n") == std::string::npos;
+}
+
+class JsonReader {
+public:
+  explicit JsonReader(const std::string &text) : _s(text), _pos(0) {}
+
+  bool parseRecord(LicenseInfo &info) {
+    bool hasStart = false, hasEnd = false;
+    if (!consume('{'))
+      return false;
+    skipSpace();
+    if (peek() == '}') {
+      ++_pos;
+      return false;
+    }
+    while (true) {
+      std::string key;
+      if (!parseString(key) || !consume(':'))
+        return false;
+      if (key == "deviceFingerprint") {
+        if (!parseString(info.deviceFingerprint))
+          return false;
+      } else if (key == "validStart") {
+        if (!parseInteger(info.validStart))
+          return false;
+        hasStart = true;
+      } else if (key == "validEnd") {
+        if (!parseInteger(info.validEnd))
+          return false;
+        hasEnd = true;
+      } else if (key == "allowedFeatures") {
+        if (!parseStringArray(info.allowedFeatures))
+          return false;
+      } else if (!skipValue()) {
+        return false;
+      }
+      skipSpace();
+      if (peek() == ',') {
+        ++_pos;
+        continue;
+      }
+      if (!consume('}'))
+        return false;
+      break;
+    }
+    skipSpace();
+    return _pos == _s.size() && hasStart && hasEnd;
+  }
+
+private:
+  char peek() const { return _pos < _s.size() ? _s[_pos] : '\0'; }
+
+  void skipSpace() {
+    while (_pos < _s.size() && std::isspace(static_cast<unsigned char>(_s[_pos])))
+      ++_pos;
+  }
+
+  bool consume(char c) {
+    skipSpace();
+    if (peek() != c)
+      return false;
+    ++_pos;
+    return true;
+  }
+
+  bool parseString(std::string &out) {
+    if (!consume('"'))
+      return false;
+    out.clear();
+    while (_pos < _s.size()) {
+      char c = _s[_pos++];
+      if (c == '"')
+        return true;
+      if (c != '\\') {
+        out += c;
+        continue;
+      }
+      if (_pos >= _s.size())
+        return false;
+      char e = _s[_pos++];
+      switch (e) {
+      case '"': out += '"'; break;
+      case '\\': out += '\\'; break;
+      case '/': out += '/'; break;
+      case 'b': out += '\b'; break;
+      case 'f': out += '\f'; break;
+      case 'n': out += '\n'; break;
+      case 'r': out += '\r'; break;
+      case 't': out += '\t'; break;
+      case 'u': {
+        unsigned long cp = 0;
+        if (!parseHex4(cp))
+          return false;
+        // 代理对合并为一个码点，不成对的代理项无法编码为合法的UTF-8
+        if (cp >= 0xD800 && cp <= 0xDBFF) {
+          unsigned long low = 0;
+          if (_s.compare(_pos, 2, "\\u") != 0)
+            return false;
+          _pos += 2;
+          if (!parseHex4(low) || low < 0xDC00 || low > 0xDFFF)
+            return false;
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+          return false;
+        }
+        // 以UTF-8编码输出
+        if (cp < 0x80) {
+          out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+          out += static_cast<char>(0xC0 | (cp >> 6));
+          out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+          out += static_cast<char>(0xE0 | (cp >> 12));
+          out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+          out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+          out += static_cast<char>(0xF0 | (cp >> 18));
+          out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+          out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+          out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        break;
+      }
+      default:
+        return false;
+      }
+    }
+    return false;
+  }
+
+  // 读取\u后的4位十六进制数字
+  bool parseHex4(unsigned long &out) {
+    if (_pos + 4 > _s.size())
+      return false;
+    for (size_t i = 0; i < 4; ++i)
+      if (!std::isxdigit(static_cast<unsigned char>(_s[_pos + i])))
+        return false;
+    out = std::strtoul(_s.substr(_pos, 4).c_str(), nullptr, 16);
+    _pos += 4;
+    return true;
+  }
+
+  bool parseInteger(long long &out) {
+    skipSpace();
+    const char *begin = _s.c_str() + _pos;
+    char *end = nullptr;
+    if (!parseTimestamp(begin, end, out))
+      return false;
+    _pos += end - begin;
+    return true;
+  }
+
+  bool parseStringArray(std::vector<std::string> &out) {
+    out.clear();
+    if (!consume('['))
+      return false;
+    skipSpace();
+    if (peek() == ']') {
+      ++_pos;
+      return true;
+    }
+    while (true) {
+      std::string item;
+      if (!parseString(item))
+        return false;
+      out.push_back(std::move(item));
+      skipSpace();
+      if (peek() == ',') {
+        ++_pos;
+        continue;
+      }
+      return consume(']');
+    }
+  }
+
+  // 跳过未知字段的值(标量、字符串或嵌套结构)
+  bool skipValue() {
+    skipSpace();
+    char c = peek();
+    if (c == '"') {
+      std::string ignored;
+      return parseString(ignored);
+    }
+    if (c == '{' || c == '[') {
+      int depth = 0;
+      while (_pos < _s.size()) {
+        char ch = _s[_pos];
+        if (ch == '"') {
+          std::string ignored;
+          if (!parseString(ignored))
+            return false;
+          continue;
+        }
+        ++_pos;
+        if (ch == '{' || ch == '[')
+          ++depth;
+        else if ((ch == '}' || ch == ']') && --depth == 0)
+          return true;
+      }
+      return false;
+    }
+    size_t start = _pos;
+    while (_pos < _s.size() && _s[_pos] != ',' && _s[_pos] != '}')
+      ++_pos;
+    return _pos > start;
+  }
+
+  const std::string &_s;
+  size_t _pos;
+};
+
+// ---------------- CSV解析 ----------------
+
+bool splitCsv(const std::string &line, std::vector<std::string> &fields) {
+  fields.clear();
+  std::string field;
+  bool quoted = false;
+  for (size_t i = 0; i < line.size(); ++i) {
+    char c = line[i];
+    if (quoted) {
+      if (c == '"') {
+        if (i + 1 < line.size() && line[i + 1] == '"') {
+          field += '"';
+          ++i;
+        } else {
+          quoted = false;
+        }
+      } else {
+        field += c;
+      }
+    } else if (c == '"') {
+      quoted = true;
+    } else if (c == ',') {
+      fields.push_back(std::move(field));
+      field.clear();
+    } else {
+      field += c;
+    }
+  }
+  fields.push_back(std::move(field));
+  return !quoted;
+}
+
+bool parseCsvRecord(const std::string &line, LicenseInfo &info) {
+  std::vector<std::string> fields;
+  if (!splitCsv(line, fields) || fields.size() < 3 || fields.size() > 4)
+    return false;
+  char *end = nullptr;
+  info.deviceFingerprint = fields[0];
+  if (!parseTimestamp(fields[1].c_str(), end, info.validStart) || *end != '\0')
+    return false;
+  if (!parseTimestamp(fields[2].c_str(), end, info.validEnd) || *end != '\0')
+    return false;
+  info.allowedFeatures.clear();
+  if (fields.size() == 4 && !fields[3].empty()) {
+    size_t start = 0;
+    while (true) {
+      size_t pos = fields[3].find(';', start);
+      info.allowedFeatures.push_back(fields[3].substr(start, pos - start));
+      if (pos == std::string::npos)
+        break;
+      start = pos + 1;
+    }
+  }
+  return true;
+}
+
+// ---------------- 输出 ----------------
+
+class LicenseWriter {
+public:
+  bool open(const Options &opt) {
+    std::error_code ec;
+    if (!opt.outDir.empty()) {
+      _dir = fs::u8path(opt.outDir);
+      if (!fs::exists(_dir, ec) && !fs::create_directories(_dir, ec)) {
+        std::cerr << "无法创建目录: " << ec.message() << std::endl;
+        return false;
+      }
+      _index.open(_dir / "index.tsv", std::ios::binary | std::ios::trunc);
+    } else {
+      _index.open(fs::u8path(opt.outFile), std::ios::binary | std::ios::trunc);
+    }
+    if (!_index.is_open()) {
+      std::cerr << "无法打开输出文件" << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool write(const Record &record) {
+    if (_dir.empty()) {
+      _index << record.index << '\t' << record.info.deviceFingerprint << '\t'
+             << record.code << '\n';
+      return _index.good();
+    }
+    std::string fileName = std::to_string(record.index) + ".lic";
+    std::ofstream file(_dir / fileName, std::ios::binary | std::ios::trunc);
+    file.write(record.code.data(), record.code.size());
+    if (!file.good()) {
+      std::cerr << "写入文件失败: " << (_dir / fileName).u8string() << std::endl;
+      return false;
+    }
+    _index << record.index << '\t' << record.info.deviceFingerprint << '\t'
+           << fileName << '\n';
+    return _index.good();
+  }
+
+  bool close() {
+    _index.flush();
+    bool ok = _index.good();
+    _index.close();
+    return ok;
+  }
+
+private:
+  fs::path _dir;
+  std::ofstream _index;
+};
+
+// 运行一个流水线阶段：从in取记录处理后送入out，结束时关闭out。
+// 失败的记录仍向下游传递(只保留序号)，以便写出阶段按序号连续推进
+template <typename Fn>
+void runStage(BoundedQueue<Record> &in, BoundedQueue<Record> &out,
+              Stats &stats, Fn fn) {
+  Record record;
+  while (in.pop(record)) {
+    if (!record.failed && !fn(record)) {
+      stats.failed++;
+      record = Record{record.index, record.lineNo};
+      record.failed = true;
+    }
+    if (!out.push(std::move(record)))
+      break;
+  }
+  out.close();
+}
+
+// 重排窗口：限制读取阶段最多领先写出阶段capacity条记录。
+// 多线程签名会打乱记录顺序，写出阶段按序号暂存乱序到达的记录，
+// 窗口保证暂存的记录数有上限，内存占用不随输入规模增长
+class ReorderWindow {
+public:
+  explicit ReorderWindow(size_t capacity) : _capacity(capacity) {}
+
+  // 等待序号index进入窗口，窗口关闭时返回false
+  bool acquire(uint64_t index) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv.wait(lock, [&] { return _closed || index < _next + _capacity; });
+    return !_closed;
+  }
+
+  // 写出阶段完成一条记录，窗口向前移动
+  void advance() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      ++_next;
+    }
+    _cv.notify_all();
+  }
+
+  void close() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _closed = true;
+    }
+    _cv.notify_all();
+  }
+
+private:
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  size_t _capacity;
+  uint64_t _next = 0;
+  bool _closed = false;
+};
+
+InputFormat detectFormat(const std::string &line) {
+  for (char c : line) {
+    if (std::isspace(static_cast<unsigned char>(c)))
+      continue;
+    return c == '{' ? InputFormat::Jsonl : InputFormat::Csv;
+  }
+  return InputFormat::Csv;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::ios::sync_with_stdio(false);
+  Options opt;
+  if (!parseOptions(argc, argv, opt)) {
+    printUsage();
+    return 1;
+  }
+
+  Crypto crypto;
+  if (!crypto.loadPrivateKeyFile(opt.keyPath))
+    return 1;
+
+  std::ifstream inputFile;
+  std::istream *input = &std::cin;
+  if (opt.inputPath != "-") {
+    inputFile.open(fs::u8path(opt.inputPath), std::ios::binary);
+    if (!inputFile.is_open()) {
+      std::cerr << "无法打开输入文件: " << opt.inputPath << std::endl;
+      return 1;
+    }
+    input = &inputFile;
+  }
+
+  LicenseWriter writer;
+  if (!writer.open(opt))
+    return 1;
+
+  // 各阶段之间的有界队列；签名阶段有多个工作线程，是其下游队列的多个生产者
+  const size_t cap = opt.queueCapacity;
+  BoundedQueue<Record> lines(cap), parsed(cap), serialized(cap);
+  BoundedQueue<Record> signedRecords(cap, opt.threads), encoded(cap);
+  Stats stats;
+  std::atomic<InputFormat> format{opt.format};
+  // 窗口覆盖所有队列与签名线程中可能同时存在的记录
+  ReorderWindow window(cap * 5 + opt.threads);
+
+  std::vector<std::thread> workers;
+
+  // 读取
+  workers.emplace_back([&] {
+    std::string line;
+    uint64_t lineNo = 0, index = 0;
+    while (std::getline(*input, line)) {
+      ++lineNo;
+      if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+      if (line.find_first_not_of(" \t") == std::string::npos)
+        continue;
+      if (format.load() == InputFormat::Auto)
+        format = detectFormat(line);
+      // 跳过CSV表头
+      if (format.load() == InputFormat::Csv && index == 0 &&
+          line.rfind("deviceFingerprint", 0) == 0)
+        continue;
+      Record record;
+      record.index = index++;
+      record.lineNo = lineNo;
+      record.line = std::move(line);
+      stats.read++;
+      if (!window.acquire(record.index) || !lines.push(std::move(record)))
+        break;
+    }
+    lines.close();
+  });
+
+  // 解析
+  workers.emplace_back([&] {
+    runStage(lines, parsed, stats, [&](Record &r) {
+      bool ok = format.load() == InputFormat::Jsonl
+                    ? JsonReader(r.line).parseRecord(r.info)
+                    : parseCsvRecord(r.line, r.info);
+      if (!ok) {
+        std::cerr << "第" << r.lineNo << "行解析失败，已跳过" << std::endl;
+      } else if (!isIndexSafe(r.info.deviceFingerprint)) {
+        std::cerr << "第" << r.lineNo << "行设备指纹包含制表符或换行符，已跳过"
+                  << std::endl;
+        ok = false;
+      }
+      r.line.clear();
+      r.line.shrink_to_fit();
+      return ok;
+    });
+  });
+
+  // 序列化
+  workers.emplace_back([&] {
+    runStage(parsed, serialized, stats, [](Record &r) {
+      r.data << r.info;
+      return true;
+    });
+  });
+
+  // 签名(RSA运算最耗时，使用多个线程)
+  for (size_t i = 0; i < opt.threads; ++i) {
+    workers.emplace_back([&] {
+      runStage(serialized, signedRecords, stats, [&](Record &r) {
+        r.signature = crypto.signData(r.data);
+        if (r.signature.empty())
+          std::cerr << "第" << r.lineNo << "行签名失败，已跳过" << std::endl;
+        return !r.signature.empty();
+      });
+    });
+  }
+
+  // Base64编码
+  workers.emplace_back([&] {
+    runStage(signedRecords, encoded, stats, [](Record &r) {
+      r.code = base64_encode(r.data) + "|" + base64_encode(r.signature);
+      r.data.clear();
+      r.signature.clear();
+      return true;
+    });
+  });
+
+  // 进度报告
+  std::mutex progressMutex;
+  std::condition_variable progressCv;
+  bool finished = false;
+  auto startTime = std::chrono::steady_clock::now();
+  auto elapsedSeconds = [&] {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         startTime)
+        .count();
+  };
+  std::thread reporter([&] {
+    std::unique_lock<std::mutex> lock(progressMutex);
+    while (!progressCv.wait_for(lock, std::chrono::seconds(1),
+                                [&] { return finished; })) {
+      double secs = elapsedSeconds();
+      uint64_t done = stats.written.load();
+      std::cerr << "已读取 " << stats.read.load() << " 条, 已签发 " << done
+                << " 条, 失败 " << stats.failed.load() << " 条, "
+                << static_cast<uint64_t>(secs > 0 ? done / secs : 0)
+                << " 条/秒" << std::endl;
+    }
+  });
+
+  // 写出(在主线程中进行)，按输入顺序输出
+  bool writeOk = true;
+  std::map<uint64_t, Record> pending;
+  uint64_t nextIndex = 0;
+  Record record;
+  while (encoded.pop(record)) {
+    uint64_t index = record.index;
+    pending.emplace(index, std::move(record));
+    for (auto it = pending.begin();
+         it != pending.end() && it->first == nextIndex;
+         it = pending.erase(it), ++nextIndex, window.advance()) {
+      if (it->second.failed)
+        continue;
+      if (!writer.write(it->second)) {
+        writeOk = false;
+        stats.failed++;
+        continue;
+      }
+      stats.written++;
+    }
+  }
+  window.close();
+  writeOk = writer.close() && writeOk;
+
+  for (auto &worker : workers)
+    worker.join();
+  {
+    std::lock_guard<std::mutex> lock(progressMutex);
+    finished = true;
+  }
+  progressCv.notify_all();
+  reporter.join();
+
+  double secs = elapsedSeconds();
+  uint64_t done = stats.written.load();
+  std::cerr << "完成: 签发 " << done << " 条, 失败 " << stats.failed.load()
+            << " 条, 用时 " << secs << " 秒, 平均 "
+            << static_cast<uint64_t>(secs > 0 ? done / secs : 0) << " 条/秒"
+            << std::endl;
+  return writeOk && stats.failed.load() == 0 ? 0 : 2;
+}
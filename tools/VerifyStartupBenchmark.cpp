@@ -0,0 +1,134 @@
+// 验证程序启动耗时与内存占用基准测试
+//
+// 同一源文件编译为两个程序:
+//   VerifyStartupBenchmark          链接LicenseManager(OpenSSL)
+//   VerifyStartupBenchmarkVerifier  链接LicenseVerifier(不依赖OpenSSL)
+// 驱动模式下重复启动自身的子进程，每个子进程加载公钥并验证一次许可证，
+// 统计从启动子进程到验证完成的平均耗时，以及子进程的峰值常驻内存。
+// 耗时包含shell启动开销，两个程序相同，对比时可抵消。
+//
+// 用法: VerifyStartupBenchmark[Verifier] public.pem license.lic fingerprint [runs]
+// 许可证需使用Ed25519私钥签发，例如:
+//   LicenseIssuer --key private.pem --input in.jsonl --out licenses.idx
+//   head -1 licenses.idx | cut -f3 > license.lic
+
+#include "LicenseInfo.h"
+#ifdef VERIFY_WITH_LICENSEVERIFIER
+#include "LicenseVerifier.h"
+#else
+#include "LicenseManager.h"
+#endif
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#define popen _popen
+#define pclose _pclose
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+#ifdef VERIFY_WITH_LICENSEVERIFIER
+const char *VARIANT = "LicenseVerifier";
+#else
+const char *VARIANT = "LicenseManager";
+#endif
+
+// 当前进程的峰值常驻内存(KB)
+long peakResidentKb() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return 0;
+  return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+  return usage.ru_maxrss; // Linux下单位为KB
+#endif
+}
+
+// 子进程：加载公钥并验证一次许可证，输出峰值常驻内存
+int runOnce(const std::string &publicKey, const std::string &licensePath,
+            const std::string &fingerprint) {
+  std::ifstream file(licensePath, std::ios::binary);
+  std::string code((std::istreambuf_iterator<char>(file)),
+                   std::istreambuf_iterator<char>());
+  while (!code.empty() && std::isspace(static_cast<unsigned char>(code.back())))
+    code.pop_back();
+
+  LicenseInfo info;
+#ifdef VERIFY_WITH_LICENSEVERIFIER
+  LicenseVerifier verifier;
+  bool ok = verifier.loadPublicKeyFile(publicKey) &&
+            verifier.verifyLicense(code, info, fingerprint);
+#else
+  LicenseManager *manager = LicenseManager::Instance("", publicKey);
+  bool ok = manager && manager->verifyLicense(code, info, fingerprint);
+#endif
+  std::cout << peakResidentKb() << std::endl;
+  return ok ? 0 : 1;
+}
+
+std::string quote(const std::string &arg) { return "\"" + arg + "\""; }
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc >= 5 && std::string(argv[1]) == "--once")
+    return runOnce(argv[2], argv[3], argv[4]);
+  if (argc < 4) {
+    std::cerr << "用法: " << argv[0]
+              << " public.pem license.lic fingerprint [runs]" << std::endl;
+    return 1;
+  }
+  const int runs = argc > 4 ? std::max(1, std::atoi(argv[4])) : 50;
+
+  std::string command = quote(argv[0]) + " --once " + quote(argv[1]) + " " +
+                        quote(argv[2]) + " " + quote(argv[3]);
+#ifdef _WIN32
+  // cmd /c 会去掉整条命令最外层的引号
+  command = quote(command);
+#endif
+
+  double totalMs = 0;
+  long maxRssKb = 0;
+  for (int i = 0; i < runs; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    FILE *child = popen(command.c_str(), "r");
+    if (!child) {
+      std::cerr << "无法启动子进程" << std::endl;
+      return 1;
+    }
+    long rssKb = 0;
+    if (std::fscanf(child, "%ld", &rssKb) != 1)
+      rssKb = 0;
+    int status = pclose(child);
+    totalMs += std::chrono::duration<double, std::milli>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+    if (status != 0 || rssKb <= 0) {
+      std::cerr << "第" << i + 1 << "次运行验证失败" << std::endl;
+      return 1;
+    }
+    maxRssKb = std::max(maxRssKb, rssKb);
+  }
+
+  std::cout << std::left << std::setw(16) << VARIANT << std::right
+            << std::fixed << std::setprecision(2) << "runs " << runs
+            << "    startup+verify " << std::setw(8) << totalMs / runs
+            << " ms    peak RSS " << maxRssKb << " KB" << std::endl;
+  return 0;
+}
@@ -0,0 +1,443 @@
+#include "Ed25519.h"
+#include "Sha512.h"
+#include <cstdint>
+#include <cstring>
+
+// 域元素使用5个51位分量表示(模 p = 2^255 - 19)，点使用扩展扭曲Edwards坐标。
+// 验证只处理公开数据，因此不要求常数时间实现。
+
+namespace {
+
+// ---------------- 64x64->128位乘法 ----------------
+
+// 定义ED25519_NO_INT128可强制使用分段乘法，用于在GCC/Clang下测试MSVC的路径
+#if defined(__SIZEOF_INT128__) && !defined(ED25519_NO_INT128)
+typedef unsigned __int128 u128;
+inline u128 mul64(uint64_t a, uint64_t b) { return static_cast<u128>(a) * b; }
+inline u128 add128(u128 a, u128 b) { return a + b; }
+inline u128 add64(u128 a, uint64_t b) { return a + b; }
+inline uint64_t lo64(u128 x) { return static_cast<uint64_t>(x); }
+inline uint64_t shr51(u128 x) { return static_cast<uint64_t>(x >> 51); }
+#else
+// 编译器不支持128位整数时(如MSVC)使用32位分段乘法
+struct u128 {
+  uint64_t lo, hi;
+};
+inline u128 mul64(uint64_t a, uint64_t b) {
+  uint64_t aLo = a & 0xFFFFFFFF, aHi = a >> 32;
+  uint64_t bLo = b & 0xFFFFFFFF, bHi = b >> 32;
+  uint64_t p0 = aLo * bLo, p1 = aLo * bHi, p2 = aHi * bLo, p3 = aHi * bHi;
+  uint64_t mid = (p0 >> 32) + (p1 & 0xFFFFFFFF) + (p2 & 0xFFFFFFFF);
+  u128 r;
+  r.lo = (p0 & 0xFFFFFFFF) | (mid << 32);
+  r.hi = p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+  return r;
+}
+inline u128 add128(u128 a, u128 b) {
+  u128 r;
+  r.lo = a.lo + b.lo;
+  r.hi = a.hi + b.hi + (r.lo < a.lo);
+  return r;
+}
+inline u128 add64(u128 a, uint64_t b) {
+  u128 r;
+  r.lo = a.lo + b;
+  r.hi = a.hi + (r.lo < a.lo);
+  return r;
+}
+inline uint64_t lo64(u128 x) { return x.lo; }
+inline uint64_t shr51(u128 x) { return (x.lo >> 51) | (x.hi << 13); }
+#endif
+
+// ---------------- 域运算 ----------------
+
+const uint64_t MASK51 = (1ULL << 51) - 1;
+
+struct Fe {
+  uint64_t v[5];
+};
+
+inline uint64_t load64le(const unsigned char *p) {
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; --i)
+    v = (v << 8) | p[i];
+  return v;
+}
+
+inline void store64le(unsigned char *p, uint64_t v) {
+  for (int i = 0; i < 8; ++i) {
+    p[i] = static_cast<unsigned char>(v);
+    v >>= 8;
+  }
+}
+
+Fe feFromInt(uint64_t x) {
+  Fe h = {{x, 0, 0, 0, 0}};
+  return h;
+}
+
+// 弱约简：各分量进位到51位以内，高位溢出乘19折回
+void feCarry(Fe &h) {
+  uint64_t c;
+  c = h.v[0] >> 51; h.v[0] &= MASK51; h.v[1] += c;
+  c = h.v[1] >> 51; h.v[1] &= MASK51; h.v[2] += c;
+  c = h.v[2] >> 51; h.v[2] &= MASK51; h.v[3] += c;
+  c = h.v[3] >> 51; h.v[3] &= MASK51; h.v[4] += c;
+  c = h.v[4] >> 51; h.v[4] &= MASK51; h.v[0] += c * 19;
+}
+
+Fe feAdd(const Fe &f, const Fe &g) {
+  Fe h;
+  for (int i = 0; i < 5; ++i)
+    h.v[i] = f.v[i] + g.v[i];
+  feCarry(h);
+  return h;
+}
+
+// f - g，先加上2p避免下溢
+Fe feSub(const Fe &f, const Fe &g) {
+  Fe h;
+  h.v[0] = f.v[0] + 0xFFFFFFFFFFFDAULL - g.v[0];
+  for (int i = 1; i < 5; ++i)
+    h.v[i] = f.v[i] + 0xFFFFFFFFFFFFEULL - g.v[i];
+  feCarry(h);
+  return h;
+}
+
+Fe feNeg(const Fe &f) { return feSub(feFromInt(0), f); }
+
+Fe feMul(const Fe &f, const Fe &g) {
+  const uint64_t *a = f.v, *b = g.v;
+  uint64_t b1 = b[1] * 19, b2 = b[2] * 19, b3 = b[3] * 19, b4 = b[4] * 19;
+
+  u128 r0 = add128(add128(add128(add128(mul64(a[0], b[0]), mul64(a[1], b4)),
+                                 mul64(a[2], b3)), mul64(a[3], b2)), mul64(a[4], b1));
+  u128 r1 = add128(add128(add128(add128(mul64(a[0], b[1]), mul64(a[1], b[0])),
+                                 mul64(a[2], b4)), mul64(a[3], b3)), mul64(a[4], b2));
+  u128 r2 = add128(add128(add128(add128(mul64(a[0], b[2]), mul64(a[1], b[1])),
+                                 mul64(a[2], b[0])), mul64(a[3], b4)), mul64(a[4], b3));
+  u128 r3 = add128(add128(add128(add128(mul64(a[0], b[3]), mul64(a[1], b[2])),
+                                 mul64(a[2], b[1])), mul64(a[3], b[0])), mul64(a[4], b4));
+  u128 r4 = add128(add128(add128(add128(mul64(a[0], b[4]), mul64(a[1], b[3])),
+                                 mul64(a[2], b[2])), mul64(a[3], b[1])), mul64(a[4], b[0]));
+
+  Fe h;
+  uint64_t c;
+  h.v[0] = lo64(r0) & MASK51; c = shr51(r0); r1 = add64(r1, c);
+  h.v[1] = lo64(r1) & MASK51; c = shr51(r1); r2 = add64(r2, c);
+  h.v[2] = lo64(r2) & MASK51; c = shr51(r2); r3 = add64(r3, c);
+  h.v[3] = lo64(r3) & MASK51; c = shr51(r3); r4 = add64(r4, c);
+  h.v[4] = lo64(r4) & MASK51; c = shr51(r4);
+  h.v[0] += c * 19;
+  c = h.v[0] >> 51; h.v[0] &= MASK51; h.v[1] += c;
+  return h;
+}
+
+Fe feSq(const Fe &f) { return feMul(f, f); }
+
+// z^e，e为32字节小端指数
+Fe fePow(const Fe &z, const unsigned char e[32]) {
+  Fe r = feFromInt(1);
+  for (int i = 254; i >= 0; --i) {
+    r = feSq(r);
+    if ((e[i >> 3] >> (i & 7)) & 1)
+      r = feMul(r, z);
+  }
+  return r;
+}
+
+Fe feFromBytes(const unsigned char s[32]) {
+  Fe h;
+  h.v[0] = load64le(s) & MASK51;
+  h.v[1] = (load64le(s + 6) >> 3) & MASK51;
+  h.v[2] = (load64le(s + 12) >> 6) & MASK51;
+  h.v[3] = (load64le(s + 19) >> 1) & MASK51;
+  h.v[4] = (load64le(s + 24) >> 12) & MASK51;
+  return h;
+}
+
+// 完全约简到[0, p)后输出32字节小端编码
+void feToBytes(unsigned char s[32], const Fe &f) {
+  Fe t = f;
+  feCarry(t);
+  feCarry(t);
+  feCarry(t);
+  // 此时 t < 2^255，加19后若溢出2^255说明 t >= p
+  t.v[0] += 19;
+  feCarry(t);
+  // 加上 2^255 - 19 并丢弃2^255位，得到 t mod p
+  t.v[0] += (1ULL << 51) - 19;
+  for (int i = 1; i < 5; ++i)
+    t.v[i] += (1ULL << 51) - 1;
+  uint64_t c;
+  c = t.v[0] >> 51; t.v[0] &= MASK51; t.v[1] += c;
+  c = t.v[1] >> 51; t.v[1] &= MASK51; t.v[2] += c;
+  c = t.v[2] >> 51; t.v[2] &= MASK51; t.v[3] += c;
+  c = t.v[3] >> 51; t.v[3] &= MASK51; t.v[4] += c;
+  t.v[4] &= MASK51;
+
+  store64le(s, t.v[0] | (t.v[1] << 51));
+  store64le(s + 8, (t.v[1] >> 13) | (t.v[2] << 38));
+  store64le(s + 16, (t.v[2] >> 26) | (t.v[3] << 25));
+  store64le(s + 24, (t.v[3] >> 39) | (t.v[4] << 12));
+}
+
+bool feIsZero(const Fe &f) {
+  unsigned char s[32];
+  feToBytes(s, f);
+  unsigned char acc = 0;
+  for (int i = 0; i < 32; ++i)
+    acc |= s[i];
+  return acc == 0;
+}
+
+bool feIsNegative(const Fe &f) {
+  unsigned char s[32];
+  feToBytes(s, f);
+  return s[0] & 1;
+}
+
+// ---------------- 群运算 ----------------
+
+// 扩展坐标 (X:Y:Z:T)，x = X/Z, y = Y/Z, x*y = T/Z
+struct Ge {
+  Fe X, Y, Z, T;
+};
+
+struct Constants {
+  Fe d;      ///< 曲线参数 d = -121665/121666
+  Fe d2;     ///< 2d
+  Fe sqrtM1; ///< sqrt(-1)
+  Ge base;   ///< 基点B
+  bool ok;
+  Constants();
+};
+
+// p - 2，用于求逆
+const unsigned char EXP_P_MINUS_2[32] = {
+    0xeb, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f};
+// (p - 5) / 8，用于求平方根
+const unsigned char EXP_P_MINUS_5_DIV_8[32] = {
+    0xfd, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x0f};
+// (p - 1) / 4，2的该次幂为sqrt(-1)
+const unsigned char EXP_P_MINUS_1_DIV_4[32] = {
+    0xfb, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x1f};
+// 群的阶 L = 2^252 + 27742317777372353535851937790883648493
+const unsigned char ORDER_L[32] = {
+    0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7,
+    0xa2, 0xde, 0xf9, 0xde, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10};
+
+Fe feInvert(const Fe &z) { return fePow(z, EXP_P_MINUS_2); }
+
+const Constants &constants() {
+  static const Constants c;
+  return c;
+}
+
+Ge geIdentity() {
+  Ge r;
+  r.X = feFromInt(0);
+  r.Y = feFromInt(1);
+  r.Z = feFromInt(1);
+  r.T = feFromInt(0);
+  return r;
+}
+
+Ge geAdd(const Ge &p, const Ge &q, const Fe &d2) {
+  Fe a = feMul(feSub(p.Y, p.X), feSub(q.Y, q.X));
+  Fe b = feMul(feAdd(p.Y, p.X), feAdd(q.Y, q.X));
+  Fe c = feMul(feMul(p.T, d2), q.T);
+  Fe zz = feMul(p.Z, q.Z);
+  Fe d = feAdd(zz, zz);
+  Fe e = feSub(b, a);
+  Fe f = feSub(d, c);
+  Fe g = feAdd(d, c);
+  Fe h = feAdd(b, a);
+  Ge r;
+  r.X = feMul(e, f);
+  r.Y = feMul(g, h);
+  r.T = feMul(e, h);
+  r.Z = feMul(f, g);
+  return r;
+}
+
+Ge geDouble(const Ge &p) {
+  Fe a = feSq(p.X);
+  Fe b = feSq(p.Y);
+  Fe zz = feSq(p.Z);
+  Fe c = feAdd(zz, zz);
+  Fe h = feAdd(a, b);
+  Fe e = feSub(h, feSq(feAdd(p.X, p.Y)));
+  Fe g = feSub(a, b);
+  Fe f = feAdd(c, g);
+  Ge r;
+  r.X = feMul(e, f);
+  r.Y = feMul(g, h);
+  r.T = feMul(e, h);
+  r.Z = feMul(f, g);
+  return r;
+}
+
+Ge geNeg(const Ge &p) {
+  Ge r = p;
+  r.X = feNeg(p.X);
+  r.T = feNeg(p.T);
+  return r;
+}
+
+void geToBytes(unsigned char s[32], const Ge &p) {
+  Fe zi = feInvert(p.Z);
+  Fe x = feMul(p.X, zi);
+  Fe y = feMul(p.Y, zi);
+  feToBytes(s, y);
+  s[31] ^= static_cast<unsigned char>(feIsNegative(x) << 7);
+}
+
+// 点解码(RFC 8032 5.1.3)
+bool geFromBytes(Ge &r, const unsigned char s[32], const Fe &d,
+                 const Fe &sqrtM1) {
+  Fe y = feFromBytes(s);
+  // 拒绝非规范编码(y >= p)
+  unsigned char check[32];
+  feToBytes(check, y);
+  if (memcmp(check, s, 31) != 0 || check[31] != (s[31] & 0x7f))
+    return false;
+  bool sign = (s[31] >> 7) != 0;
+
+  Fe yy = feSq(y);
+  Fe u = feSub(yy, feFromInt(1));
+  Fe v = feAdd(feMul(d, yy), feFromInt(1));
+  // x = u * v^3 * (u * v^7)^((p-5)/8)
+  Fe v3 = feMul(feSq(v), v);
+  Fe v7 = feMul(feSq(v3), v);
+  Fe x = feMul(feMul(u, v3), fePow(feMul(u, v7), EXP_P_MINUS_5_DIV_8));
+
+  Fe vxx = feMul(v, feSq(x));
+  if (!feIsZero(feSub(vxx, u))) {
+    if (!feIsZero(feAdd(vxx, u)))
+      return false;
+    x = feMul(x, sqrtM1);
+  }
+  if (feIsZero(x) && sign)
+    return false;
+  if (feIsNegative(x) != sign)
+    x = feNeg(x);
+
+  r.X = x;
+  r.Y = y;
+  r.Z = feFromInt(1);
+  r.T = feMul(x, y);
+  return true;
+}
+
+Constants::Constants() {
+  d = feMul(feNeg(feFromInt(121665)), feInvert(feFromInt(121666)));
+  d2 = feAdd(d, d);
+  sqrtM1 = fePow(feFromInt(2), EXP_P_MINUS_1_DIV_4);
+  // 基点 y = 4/5，x为正
+  unsigned char b[32];
+  memset(b, 0x66, sizeof(b));
+  b[0] = 0x58;
+  ok = geFromBytes(base, b, d, sqrtM1);
+}
+
+// ---------------- 标量运算 ----------------
+
+// 将64字节小端整数约简为模L的32字节结果
+void scReduce(unsigned char r[32], const unsigned char x64[64]) {
+  int64_t x[64];
+  for (int i = 0; i < 64; ++i)
+    x[i] = x64[i];
+  for (int i = 63; i >= 32; --i) {
+    int64_t carry = 0;
+    int j;
+    for (j = i - 32; j < i - 12; ++j) {
+      x[j] += carry - 16 * x[i] * ORDER_L[j - (i - 32)];
+      carry = (x[j] + 128) >> 8;
+      x[j] -= carry * 256;
+    }
+    x[j] += carry;
+    x[i] = 0;
+  }
+  int64_t carry = 0;
+  for (int j = 0; j < 32; ++j) {
+    x[j] += carry - (x[31] >> 4) * ORDER_L[j];
+    carry = x[j] >> 8;
+    x[j] &= 255;
+  }
+  for (int j = 0; j < 32; ++j)
+    x[j] -= carry * ORDER_L[j];
+  for (int i = 0; i < 32; ++i) {
+    if (i < 31)
+      x[i + 1] += x[i] >> 8;
+    r[i] = static_cast<unsigned char>(x[i] & 255);
+  }
+}
+
+// 判断标量是否小于L
+bool scIsCanonical(const unsigned char s[32]) {
+  for (int i = 31; i >= 0; --i) {
+    if (s[i] < ORDER_L[i])
+      return true;
+    if (s[i] > ORDER_L[i])
+      return false;
+  }
+  return false;
+}
+
+inline int bitAt(const unsigned char s[32], int i) {
+  return (s[i >> 3] >> (i & 7)) & 1;
+}
+
+} // namespace
+
+bool Ed25519::verify(const unsigned char signature[SIGNATURE_SIZE],
+                     const unsigned char *message, size_t len,
+                     const unsigned char publicKey[PUBLIC_KEY_SIZE]) {
+  const Constants &c = constants();
+  if (!c.ok)
+    return false;
+  const unsigned char *R = signature;
+  const unsigned char *S = signature + 32;
+  if (!scIsCanonical(S))
+    return false;
+
+  Ge A;
+  if (!geFromBytes(A, publicKey, c.d, c.sqrtM1))
+    return false;
+  Ge negA = geNeg(A);
+
+  // k = SHA-512(R || A || M) mod L
+  unsigned char digest[Sha512::DIGEST_SIZE];
+  Sha512 sha;
+  sha.update(R, 32);
+  sha.update(publicKey, PUBLIC_KEY_SIZE);
+  sha.update(message, len);
+  sha.final(digest);
+  unsigned char k[32];
+  scReduce(k, digest);
+
+  // 计算 [S]B - [k]A (Shamir双标量乘法)，与R比较
+  Ge sum = geAdd(c.base, negA, c.d2);
+  Ge acc = geIdentity();
+  for (int i = 255; i >= 0; --i) {
+    acc = geDouble(acc);
+    int sb = bitAt(S, i), kb = bitAt(k, i);
+    if (sb && kb)
+      acc = geAdd(acc, sum, c.d2);
+    else if (sb)
+      acc = geAdd(acc, c.base, c.d2);
+    else if (kb)
+      acc = geAdd(acc, negA, c.d2);
+  }
+  unsigned char check[32];
+  geToBytes(check, acc);
+  return memcmp(check, R, 32) == 0;
+}
@@ -0,0 +1,29 @@
+#ifndef ED25519_H
+#define ED25519_H
+
+#include <cstddef>
+
+/**
+ * @brief 自包含的Ed25519签名验证(RFC 8032)，不依赖OpenSSL
+ *
+ * 仅实现验证功能，签名由OpenSSL等完整实现生成。
+ */
+class Ed25519 {
+public:
+  static const size_t PUBLIC_KEY_SIZE = 32;
+  static const size_t SIGNATURE_SIZE = 64;
+
+  /**
+   * @brief 验证Ed25519签名
+   * @param signature 64字节签名(R || S)
+   * @param message 消息数据
+   * @param len 消息长度
+   * @param publicKey 32字节公钥
+   * @return 签名有效返回true，否则返回false
+   */
+  static bool verify(const unsigned char signature[SIGNATURE_SIZE],
+                     const unsigned char *message, size_t len,
+                     const unsigned char publicKey[PUBLIC_KEY_SIZE]);
+};
+
+#endif // ED25519_H
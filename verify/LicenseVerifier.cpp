@@ -0,0 +1,108 @@
+#include "LicenseVerifier.h"
+#include "Base64.h"
+#include "Ed25519.h"
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <vector>
+#include <filesystem>
+namespace fs = std::filesystem;
+
+namespace {
+
+// Ed25519公钥的SubjectPublicKeyInfo前缀(RFC 8410)，其后为32字节公钥
+const unsigned char ED25519_SPKI_PREFIX[12] = {0x30, 0x2a, 0x30, 0x05,
+                                               0x06, 0x03, 0x2b, 0x65,
+                                               0x70, 0x03, 0x21, 0x00};
+
+} // namespace
+
+LicenseVerifier::LicenseVerifier() : _publicKey{}, _hasPublicKey(false) {}
+
+bool LicenseVerifier::loadPublicKeyFile(const std::string &path) {
+  // path 是 UTF-8 字符串
+  std::ifstream file(fs::u8path(path), std::ios::binary);
+  if (!file.is_open()) {
+    std::cerr << "open PublicKey file error" << std::endl;
+    return false;
+  }
+  std::string data((std::istreambuf_iterator<char>(file)),
+                   std::istreambuf_iterator<char>());
+  // 非PEM内容按DER格式解析
+  if (!data.empty() && static_cast<unsigned char>(data[0]) == 0x30) {
+    return loadPublicKeyDer(reinterpret_cast<const unsigned char *>(data.data()),
+                            data.size());
+  }
+  return loadPublicKeyStr(data);
+}
+
+bool LicenseVerifier::loadPublicKeyStr(const std::string &key) {
+  const std::string begin = "-----BEGIN PUBLIC KEY-----";
+  const std::string end = "-----END PUBLIC KEY-----";
+  size_t start = key.find(begin);
+  size_t stop = start == std::string::npos ? start : key.find(end, start);
+  if (stop == std::string::npos) {
+    std::cerr << "读取公钥失败: 不是PEM格式的公钥" << std::endl;
+    return false;
+  }
+  // base64_decode遇到非Base64字符即停止，先去除换行等空白
+  std::string body;
+  for (size_t i = start + begin.size(); i < stop; ++i) {
+    if (!isspace(static_cast<unsigned char>(key[i])))
+      body += key[i];
+  }
+  std::string der = base64_decode(body);
+  return loadPublicKeyDer(reinterpret_cast<const unsigned char *>(der.data()),
+                          der.size());
+}
+
+bool LicenseVerifier::loadPublicKeyDer(const unsigned char *der, size_t len) {
+  _hasPublicKey = false;
+  if (len != sizeof(ED25519_SPKI_PREFIX) + sizeof(_publicKey) ||
+      memcmp(der, ED25519_SPKI_PREFIX, sizeof(ED25519_SPKI_PREFIX)) != 0) {
+    std::cerr << "读取公钥失败: 仅支持Ed25519公钥" << std::endl;
+    return false;
+  }
+  memcpy(_publicKey, der + sizeof(ED25519_SPKI_PREFIX), sizeof(_publicKey));
+  _hasPublicKey = true;
+  return true;
+}
+
+bool LicenseVerifier::verifyLicense(const std::string &licenseCode,
+                                    LicenseInfo &info,
+                                    const std::string &deviceFingerprint) const {
+  if (!_hasPublicKey) {
+    std::cerr << "未加载公钥，无法验证" << std::endl;
+    return false;
+  }
+  std::vector<std::string> parts;
+  std::stringstream ss(licenseCode);
+  std::string item;
+  while (std::getline(ss, item, '|')) {
+    parts.push_back(item);
+  }
+  if (parts.size() != 2)
+    return false;
+  std::string data = base64_decode(parts[0]);
+  std::string signature = base64_decode(parts[1]);
+  if (signature.size() != Ed25519::SIGNATURE_SIZE ||
+      !Ed25519::verify(reinterpret_cast<const unsigned char *>(signature.data()),
+                       reinterpret_cast<const unsigned char *>(data.data()),
+                       data.size(), _publicKey)) {
+    std::cerr << "验证签名失败: 签名不匹配" << std::endl;
+    return false;
+  }
+  if (!LicenseInfo::isWellFormed(data))
+    return false;
+  data >> info;
+  if (info.deviceFingerprint != deviceFingerprint)
+    return false;
+  auto now = std::chrono::system_clock::now().time_since_epoch();
+  auto now_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+  return now_ms >= info.validStart && now_ms <= info.validEnd;
+}
@@ -0,0 +1,56 @@
+#ifndef LICENSEVERIFIER_H
+#define LICENSEVERIFIER_H
+
+#include "LicenseInfo.h"
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief 仅用于验证的轻量许可证校验器
+ *
+ * 使用自包含的Ed25519与SHA-512实现，不依赖OpenSSL，适用于只需验证许可证的程序。
+ * 许可证需使用Ed25519私钥签发(LicenseManager加载Ed25519私钥即可)，
+ * 验证语义与LicenseManager::verifyLicense一致。
+ */
+class LicenseVerifier {
+public:
+  LicenseVerifier();
+
+  /**
+   * @brief 从文件加载Ed25519公钥(PEM或DER格式)
+   * @param path 公钥文件路径
+   * @return 加载成功返回true，失败返回false
+   */
+  bool loadPublicKeyFile(const std::string &path);
+
+  /**
+   * @brief 从PEM字符串加载Ed25519公钥
+   * @param key 公钥字符串
+   * @return 加载成功返回true，失败返回false
+   */
+  bool loadPublicKeyStr(const std::string &key);
+
+  /**
+   * @brief 从DER数据(SubjectPublicKeyInfo)加载Ed25519公钥
+   * @param der DER编码的公钥
+   * @param len 数据长度
+   * @return 加载成功返回true，失败返回false
+   */
+  bool loadPublicKeyDer(const unsigned char *der, size_t len);
+
+  /**
+   * @brief 验证许可证的有效性
+   * @param licenseCode 待验证的许可证代码字符串
+   * @param info 用于存储许可证信息的输出参数
+   * @param deviceFingerprint 设备指纹字符串，用于绑定设备验证
+   * @return 验证成功返回true，失败返回false
+   */
+  bool verifyLicense(const std::string &licenseCode, LicenseInfo &info,
+                     const std::string &deviceFingerprint) const;
+
+private:
+  unsigned char _publicKey[32];
+  bool _hasPublicKey;
+};
+
+#endif // LICENSEVERIFIER_H
@@ -0,0 +1,139 @@
+#include "Sha512.h"
+#include <cstring>
+
+namespace {
+
+const uint64_t K[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+    0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+    0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+    0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+    0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+    0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+    0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+    0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+    0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+    0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+    0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+    0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL,
+};
+
+inline uint64_t rotr(uint64_t x, unsigned n) { return (x >> n) | (x << (64 - n)); }
+
+inline uint64_t load64be(const unsigned char *p) {
+  uint64_t v = 0;
+  for (int i = 0; i < 8; ++i)
+    v = (v << 8) | p[i];
+  return v;
+}
+
+inline void store64be(unsigned char *p, uint64_t v) {
+  for (int i = 7; i >= 0; --i) {
+    p[i] = static_cast<unsigned char>(v);
+    v >>= 8;
+  }
+}
+
+} // namespace
+
+Sha512::Sha512() : _bufferLen(0), _totalLen(0) {
+  _state[0] = 0x6a09e667f3bcc908ULL;
+  _state[1] = 0xbb67ae8584caa73bULL;
+  _state[2] = 0x3c6ef372fe94f82bULL;
+  _state[3] = 0xa54ff53a5f1d36f1ULL;
+  _state[4] = 0x510e527fade682d1ULL;
+  _state[5] = 0x9b05688c2b3e6c1fULL;
+  _state[6] = 0x1f83d9abfb41bd6bULL;
+  _state[7] = 0x5be0cd19137e2179ULL;
+}
+
+void Sha512::update(const void *data, size_t len) {
+  const unsigned char *p = static_cast<const unsigned char *>(data);
+  _totalLen += len;
+  // 先补齐缓冲区中的残留分组
+  if (_bufferLen > 0) {
+    size_t n = sizeof(_buffer) - _bufferLen;
+    if (n > len)
+      n = len;
+    memcpy(_buffer + _bufferLen, p, n);
+    _bufferLen += n;
+    p += n;
+    len -= n;
+    if (_bufferLen < sizeof(_buffer))
+      return;
+    transform(_buffer);
+    _bufferLen = 0;
+  }
+  // 整分组直接处理，不经过缓冲区
+  while (len >= sizeof(_buffer)) {
+    transform(p);
+    p += sizeof(_buffer);
+    len -= sizeof(_buffer);
+  }
+  memcpy(_buffer, p, len);
+  _bufferLen = len;
+}
+
+void Sha512::final(unsigned char digest[DIGEST_SIZE]) {
+  // 填充: 0x80 + 0... + 128位消息长度(位数)
+  uint64_t bitLen = _totalLen << 3;
+  uint64_t bitLenHigh = _totalLen >> 61;
+  _buffer[_bufferLen++] = 0x80;
+  if (_bufferLen > 112) {
+    memset(_buffer + _bufferLen, 0, sizeof(_buffer) - _bufferLen);
+    transform(_buffer);
+    _bufferLen = 0;
+  }
+  memset(_buffer + _bufferLen, 0, 112 - _bufferLen);
+  store64be(_buffer + 112, bitLenHigh);
+  store64be(_buffer + 120, bitLen);
+  transform(_buffer);
+  for (int i = 0; i < 8; ++i)
+    store64be(digest + i * 8, _state[i]);
+}
+
+void Sha512::transform(const unsigned char block[128]) {
+  uint64_t w[80];
+  for (int i = 0; i < 16; ++i)
+    w[i] = load64be(block + i * 8);
+  for (int i = 16; i < 80; ++i) {
+    uint64_t s0 = rotr(w[i - 15], 1) ^ rotr(w[i - 15], 8) ^ (w[i - 15] >> 7);
+    uint64_t s1 = rotr(w[i - 2], 19) ^ rotr(w[i - 2], 61) ^ (w[i - 2] >> 6);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint64_t a = _state[0], b = _state[1], c = _state[2], d = _state[3];
+  uint64_t e = _state[4], f = _state[5], g = _state[6], h = _state[7];
+  for (int i = 0; i < 80; ++i) {
+    uint64_t S1 = rotr(e, 14) ^ rotr(e, 18) ^ rotr(e, 41);
+    uint64_t ch = (e & f) ^ (~e & g);
+    uint64_t t1 = h + S1 + ch + K[i] + w[i];
+    uint64_t S0 = rotr(a, 28) ^ rotr(a, 34) ^ rotr(a, 39);
+    uint64_t maj = (a & b) ^ (a & c) ^ (b & c);
+    uint64_t t2 = S0 + maj;
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+  _state[0] += a;
+  _state[1] += b;
+  _state[2] += c;
+  _state[3] += d;
+  _state[4] += e;
+  _state[5] += f;
+  _state[6] += g;
+  _state[7] += h;
+}
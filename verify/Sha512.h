@@ -0,0 +1,38 @@
+#ifndef SHA512_H
+#define SHA512_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 自包含的SHA-512实现(FIPS 180-4)，不依赖OpenSSL
+ */
+class Sha512 {
+public:
+  static const size_t DIGEST_SIZE = 64;
+
+  Sha512();
+
+  /**
+   * @brief 追加待计算的数据
+   * @param data 数据指针
+   * @param len 数据长度
+   */
+  void update(const void *data, size_t len);
+
+  /**
+   * @brief 完成计算并输出摘要，之后对象需重新构造才能再次使用
+   * @param digest 输出参数，64字节摘要
+   */
+  void final(unsigned char digest[DIGEST_SIZE]);
+
+private:
+  void transform(const unsigned char block[128]);
+
+  uint64_t _state[8];
+  unsigned char _buffer[128];
+  size_t _bufferLen;
+  uint64_t _totalLen;
+};
+
+#endif // SHA512_H